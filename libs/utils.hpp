@@ -1,28 +1,79 @@
 #ifndef UTIL_HPP
 #define UTIL_HPP
 
-#include <string_view>
-#include <vector>
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string_view>
 
 namespace utils {
 
-[[nodiscard]] static auto split(const std::string_view str, const std::string_view delims = " ")
-    -> std::vector<std::string_view> {
-    std::vector<std::string_view> output;
+// Fixed capacity list of parts of a string
+template <std::size_t N>
+class [[nodiscard]] Tokens {
+   public:
+    constexpr auto push(const std::string_view part) noexcept -> void {
+        m_parts[m_size] = part;
+        m_size++;
+    }
+
+    [[nodiscard]] constexpr auto size() const noexcept -> std::size_t {
+        return m_size;
+    }
+
+    [[nodiscard]] constexpr auto empty() const noexcept -> bool {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] constexpr auto full() const noexcept -> bool {
+        return m_size == N;
+    }
+
+    [[nodiscard]] constexpr auto operator[](const std::size_t idx) const noexcept -> std::string_view {
+        return m_parts[idx];
+    }
 
-    for (auto first = str.data(), second = str.data(), last = first + str.size(); second != last && first != last;
-         first = second + 1) {
-        second = std::find_first_of(first, last, std::cbegin(delims), std::cend(delims));
+    [[nodiscard]] constexpr auto begin() const noexcept {
+        return m_parts.begin();
+    }
+
+    [[nodiscard]] constexpr auto end() const noexcept {
+        return m_parts.begin() + m_size;
+    }
 
-        if (first != second) {
-            output.emplace_back(first, second - first);
+   private:
+    std::array<std::string_view, N> m_parts{};
+    std::size_t m_size = 0;
+};
+
+// Split a string on any of the delimiters without allocating. Anything past the first N parts is dropped.
+template <std::size_t N = 64>
+[[nodiscard]] constexpr auto tokenize(const std::string_view str, const std::string_view delims = " ") -> Tokens<N> {
+    Tokens<N> output;
+    std::size_t pos = 0;
+
+    while (!output.full()) {
+        const auto first = str.find_first_not_of(delims, pos);
+        if (first == std::string_view::npos) {
+            break;
         }
+
+        pos = std::min(str.find_first_of(delims, first), str.size());
+        output.push(str.substr(first, pos - first));
     }
 
     return output;
 }
 
+static_assert(tokenize("").empty());
+static_assert(tokenize("   ").empty());
+static_assert(tokenize("bestmove a1a3 ponder b2").size() == 4);
+static_assert(tokenize("bestmove a1a3 ponder b2")[3] == "b2");
+static_assert(tokenize("  info   depth 5 ")[2] == "5");
+static_assert(tokenize<2>("a b c").size() == 2);
+static_assert(tokenize<2>("a b c")[1] == "b");
+static_assert(tokenize("= a1\r", " \r")[1] == "a1");
+
 }  // namespace utils
 
 #endif
@@ -1,13 +1,18 @@
+#include <atomic>
 #include <chrono>
+#include <csignal>
 #include <elo.hpp>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <optional>
 #include <sprt.hpp>
 #include <stdexcept>
 #include <thread>
 #include "core/engine/engine.hpp"
+#include "core/engine/log.hpp"
 #include "core/match/callbacks.hpp"
+#include "core/match/checkpoint.hpp"
 #include "core/match/run.hpp"
 #include "core/match/settings.hpp"
 #include "core/parse/openings.hpp"
@@ -19,16 +24,46 @@ int main(int argc, char **argv) {
         return 1;
     }
 
+    const auto resume = argc > 2 && std::string(argv[2]) == "--resume";
+
+    // Writing to an engine that has crashed should fail rather than kill us
+    std::signal(SIGPIPE, SIG_IGN);
+
     try {
-        const auto settings = parse::settings(argv[1]);
-        const auto openings = parse::openings(settings.openings_path, settings.shuffle);
+        auto settings = parse::settings(argv[1]);
+
+        // A resumed tournament has to play the same games as before, so it goes back to the seed it started with
+        std::optional<Checkpoint> checkpoint;
+        if (resume) {
+            checkpoint = load_checkpoint(settings);
+            settings.seed = checkpoint->seed;
+        }
+
+        const auto openings = parse::openings(settings.openings_path, settings.shuffle, settings.seed);
+
+        // Engine stderr and debug output go to log files instead of the terminal
+        std::optional<EngineLog> engine_log;
+        if (!settings.logs.path.empty()) {
+            engine_log.emplace(settings.logs.path, settings.logs.max_size);
+        }
+
+        // Including restarts after a crash
+        std::atomic<int> engines_started = 0;
+
         const auto callbacks = Callbacks{
             .on_engine_start =
-                [&settings](const std::string &name) {
+                [&settings, &engines_started](const std::string &name) {
+                    engines_started++;
                     if (settings.verbose) {
                         std::cout << "Created engine " << name << std::endl;
                     }
                 },
+            .on_engine_ready =
+                [&settings](const std::string &name, const std::chrono::milliseconds startup) {
+                    if (settings.verbose) {
+                        std::cout << "Engine " << name << " ready in " << startup.count() << "ms" << std::endl;
+                    }
+                },
             .on_game_started =
                 [&settings](const int game_id, const std::string &engine1, const std::string &engine2) {
                     if (settings.verbose) {
@@ -51,7 +86,9 @@ int main(int argc, char **argv) {
                         const auto d = results.scores.at(e1.name).draws;
                         const auto elo = get_elo(w, l, d);
                         const auto err = get_err(w, l, d);
-                        const auto llr = sprt::get_llr(w, l, d, settings.sprt.elo0, settings.sprt.elo1);
+                        const auto &pairing = results.pairings.at({0, 1});
+                        const auto llr =
+                            get_sprt_llr(pairing, settings.sprt.pentanomial, settings.sprt.elo0, settings.sprt.elo1);
                         const auto lbound = sprt::get_lbound(settings.sprt.alpha, settings.sprt.beta);
                         const auto ubound = sprt::get_ubound(settings.sprt.alpha, settings.sprt.beta);
 
@@ -92,6 +129,11 @@ int main(int argc, char **argv) {
                         // Print SPRT
                         if (print_sprt) {
                             std::cout << "SPRT: llr " << llr << ", lbound " << lbound << ", ubound " << ubound << "\n";
+                            if (settings.sprt.pentanomial) {
+                                const auto &p = pairing.pairs;
+                                std::cout << "Pairs: [" << p[0] << ", " << p[1] << ", " << p[2] << ", " << p[3] << ", "
+                                          << p[4] << "]\n";
+                            }
                         }
 
                         // Spacer
@@ -163,32 +205,75 @@ int main(int argc, char **argv) {
                     }
                 },
             .on_info_send =
-                [](const std::string &msg) {
-                    std::cout << std::this_thread::get_id() << "> " << msg << "\n";
+                [&engine_log](const std::string &name, const std::string &msg) {
+                    if (engine_log) {
+                        engine_log->write(name, "> " + msg);
+                    } else {
+                        std::cout << std::this_thread::get_id() << "> " << msg << "\n";
+                    }
                 },
             .on_info_recv =
-                [](const std::string &msg) {
-                    std::cout << std::this_thread::get_id() << "< " << msg << "\n";
+                [&engine_log](const std::string &name, const std::string &msg) {
+                    if (engine_log) {
+                        engine_log->write(name, "< " + msg);
+                    } else {
+                        std::cout << std::this_thread::get_id() << "< " << msg << "\n";
+                    }
+                },
+            .on_search_info =
+                settings.verbose ? std::function<void(const std::string &, const SearchInfo &)>(
+                                       [](const std::string &name, const SearchInfo &info) {
+                                           std::cout << name << " depth " << info.depth;
+                                           if (info.score_type == SearchInfo::ScoreType::Cp) {
+                                               std::cout << " score cp " << info.score;
+                                           } else if (info.score_type == SearchInfo::ScoreType::Mate) {
+                                               std::cout << " score mate " << info.score;
+                                           }
+                                           std::cout << " nodes " << info.nodes;
+                                           if (!info.pv.empty()) {
+                                               std::cout << " pv " << info.pv;
+                                           }
+                                           std::cout << std::endl;
+                                       })
+                                 : nullptr,
+            .on_engine_stderr =
+                engine_log ? std::function<void(const std::string &, const int)>(
+                                 [&engine_log](const std::string &name, const int fd) {
+                                     engine_log->capture(name, fd);
+                                 })
+                           : nullptr,
+            .on_pairing_decided =
+                [](const std::string &engine1, const std::string &engine2, const float llr) {
+                    std::cout << "SPRT: " << engine1 << " vs " << engine2 << " decided with llr " << std::fixed
+                              << std::setprecision(2) << llr << ", skipping its remaining games" << std::endl;
                 },
         };
 
-        // Clear pgn
-        if (settings.pgn.override) {
+        // Clear pgn, unless it has the games we're resuming from
+        if (settings.pgn.override && !resume) {
             std::ofstream file(settings.pgn.path, std::ofstream::trunc);
         }
 
+        if (checkpoint) {
+            restore_pgn(settings, *checkpoint);
+        }
+
         std::cout << "Settings:\n";
         std::cout << "- games " << settings.num_games << "\n";
         std::cout << "- engines " << settings.engines.size() << "\n";
         std::cout << "- concurrency " << settings.concurrency << "\n";
         std::cout << "- timecontrol " << settings.tc << "\n";
         std::cout << "- openings " << openings.size() << "\n";
+        std::cout << "- seed " << settings.seed << "\n";
+        if (checkpoint) {
+            std::cout << "- resuming after " << checkpoint->results.games_played << " games\n";
+        }
         std::cout << "\n";
 
         // Start timer
         const auto t0 = std::chrono::high_resolution_clock::now();
 
-        const auto results = run(settings, openings, callbacks);
+        const auto results = run(settings, openings, callbacks, checkpoint ? checkpoint->results : Results{});
 
         // End timer
         const auto t1 = std::chrono::high_resolution_clock::now();
@@ -203,6 +288,7 @@ int main(int argc, char **argv) {
         std::cout << std::setfill('0') << std::setw(2) << hh_mm_ss.seconds().count() << "s\n";
         std::cout << "Total games: " << results.games_played << "\n";
         std::cout << "Threads: " << settings.concurrency << "\n";
+        std::cout << "Engines started: " << engines_started << "\n";
         if (diff.count() > 0) {
             const auto games_per_ms = static_cast<float>(results.games_played) / diff.count();
             const auto games_per_sec = games_per_ms * 1000;
@@ -217,6 +303,36 @@ int main(int argc, char **argv) {
         std::cout << "1-0     " << results.black_wins << "\n";
         std::cout << "0-1     " << results.white_wins << "\n";
         std::cout << "1/2-1/2 " << results.draws << "\n";
+
+        // Print time saved by engines skipping isready
+        auto first_sync = true;
+        for (const auto &[name, score] : results.scores) {
+            if (score.syncs_skipped == 0) {
+                continue;
+            }
+
+            if (first_sync) {
+                std::cout << "\n";
+                first_sync = false;
+            }
+
+            std::cout << name << " skipped " << score.syncs_skipped << " isready round trips";
+            if (score.syncs > 0) {
+                std::cout << ", saving an estimated " << estimated_sync_saving(score).count() << "ms";
+            }
+            std::cout << "\n";
+        }
+
+        if (engine_log && engine_log->num_dropped() > 0) {
+            std::cout << "\nEngine logs fell behind and dropped " << engine_log->num_dropped() << " lines\n";
+        }
+
+        // Print engine crashes
+        for (const auto &[name, score] : results.scores) {
+            if (score.crashes > 0) {
+                std::cout << name << " crashed " << score.crashes << " times\n";
+            }
+        }
     } catch (std::invalid_argument &e) {
         std::cerr << e.what() << "\n";
     } catch (const char *e) {
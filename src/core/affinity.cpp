@@ -0,0 +1,165 @@
+#include "affinity.hpp"
+#include <sched.h>
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utils.hpp>
+
+namespace {
+
+[[nodiscard]] auto to_cpu_set(const std::vector<int> &cpus) -> cpu_set_t {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const auto cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return set;
+}
+
+[[nodiscard]] auto parse_int(const std::string_view str, int &value) -> bool {
+    const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc() && ptr == str.data() + str.size();
+}
+
+}  // namespace
+
+[[nodiscard]] auto parse_cpu_list(std::string_view str) -> std::vector<int> {
+    std::vector<int> cpus;
+
+    for (const auto part : utils::tokenize<1024>(str, ", \n")) {
+        const auto dash = part.find('-');
+        int first = 0;
+        int last = 0;
+
+        if (dash == std::string_view::npos) {
+            if (!parse_int(part, first)) {
+                continue;
+            }
+            last = first;
+        } else if (!parse_int(part.substr(0, dash), first) || !parse_int(part.substr(dash + 1), last)) {
+            continue;
+        }
+
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+
+    return cpus;
+}
+
+[[nodiscard]] auto read_topology() -> std::vector<std::vector<int>> {
+    std::vector<std::vector<int>> cores;
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return cores;
+    }
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed)) {
+            continue;
+        }
+
+        // Without topology information every CPU is treated as its own core
+        auto siblings = std::vector<int>{cpu};
+
+        std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list");
+        std::string line;
+        if (file && std::getline(file, line)) {
+            siblings = parse_cpu_list(line);
+        }
+
+        // Skip siblings we aren't allowed to use
+        std::erase_if(siblings, [&allowed](const int sibling) {
+            return sibling < 0 || sibling >= CPU_SETSIZE || !CPU_ISSET(sibling, &allowed);
+        });
+
+        // Each core is listed once, by its lowest CPU
+        if (!siblings.empty() && siblings.front() == cpu) {
+            cores.push_back(siblings);
+        }
+    }
+
+    return cores;
+}
+
+[[nodiscard]] auto make_slot_cpus(const std::vector<std::vector<int>> &cores, const int num_slots, const bool avoid_smt)
+    -> std::vector<std::vector<int>> {
+    std::vector<std::vector<int>> slots(num_slots);
+
+    // Decide what we're handing out, whole cores where there are enough to go around
+    std::vector<std::vector<int>> units;
+    if (avoid_smt) {
+        for (const auto &core : cores) {
+            units.push_back({core.front()});
+        }
+    } else if (cores.size() >= slots.size()) {
+        units = cores;
+    } else {
+        for (const auto &core : cores) {
+            for (const auto cpu : core) {
+                units.push_back({cpu});
+            }
+        }
+    }
+
+    if (units.empty()) {
+        return slots;
+    }
+
+    if (units.size() >= slots.size()) {
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            const auto first = i * units.size() / slots.size();
+            const auto last = (i + 1) * units.size() / slots.size();
+            for (auto j = first; j < last; ++j) {
+                slots[i].insert(slots[i].end(), units[j].begin(), units[j].end());
+            }
+        }
+    } else {
+        // More slots than CPUs, so some of them have to share
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            slots[i] = units[i % units.size()];
+        }
+    }
+
+    return slots;
+}
+
+auto pin_thread(const std::vector<int> &cpus) -> bool {
+    if (cpus.empty()) {
+        return false;
+    }
+
+    const auto set = to_cpu_set(cpus);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+auto pin_process(const pid_t pid, const std::vector<int> &cpus) -> bool {
+    if (cpus.empty()) {
+        return false;
+    }
+
+    const auto set = to_cpu_set(cpus);
+
+    // Threads the engine has already started have to be pinned individually, later ones inherit it
+    std::error_code ec;
+    auto success = false;
+    for (const auto &entry : std::filesystem::directory_iterator("/proc/" + std::to_string(pid) + "/task", ec)) {
+        int tid = 0;
+        if (parse_int(entry.path().filename().string(), tid)) {
+            success |= sched_setaffinity(tid, sizeof(set), &set) == 0;
+        }
+    }
+
+    return success;
+}
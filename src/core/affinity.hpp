@@ -0,0 +1,26 @@
+#ifndef AFFINITY_HPP
+#define AFFINITY_HPP
+
+#include <sys/types.h>
+#include <string_view>
+#include <vector>
+
+// Logical CPU ids in the kernel's list format, e.g. "0-3,8,10-11"
+[[nodiscard]] auto parse_cpu_list(std::string_view str) -> std::vector<int>;
+
+// The physical cores we're allowed to run on, each given as its logical CPUs (SMT siblings)
+[[nodiscard]] auto read_topology() -> std::vector<std::vector<int>>;
+
+// Split the cores between the slots, keeping SMT siblings in the same slot while there's a core for every slot
+// With more slots than cores the siblings are split up, and with more slots than CPUs the slots share them
+// With avoid_smt only one logical CPU of each physical core is used
+[[nodiscard]] auto make_slot_cpus(const std::vector<std::vector<int>> &cores, const int num_slots, const bool avoid_smt)
+    -> std::vector<std::vector<int>>;
+
+// Pin the calling thread
+auto pin_thread(const std::vector<int> &cpus) -> bool;
+
+// Pin every thread of a process
+auto pin_process(const pid_t pid, const std::vector<int> &cpus) -> bool;
+
+#endif
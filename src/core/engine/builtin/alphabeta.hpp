@@ -0,0 +1,290 @@
+#ifndef BUILTIN_ALPHABETA_HPP
+#define BUILTIN_ALPHABETA_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+#include "../engine.hpp"
+#include "movegen.hpp"
+
+// Iterative deepening alpha-beta with a material evaluation and a transposition table keyed on the position hash
+// Searches to a depth or node count are deterministic, so it makes a reference opponent for regression runs
+class AlphaBetaBuiltin : public Engine {
+   public:
+    static constexpr int max_depth = 64;
+    static constexpr int mate_score = 100'000;
+    static constexpr std::size_t tt_entries = std::size_t{1} << 16;
+
+    [[nodiscard]] AlphaBetaBuiltin(std::function<void(const std::string &msg)> send = {},
+                                   std::function<void(const std::string &msg)> recv = {})
+        : Engine(send, recv), m_tt(tt_entries) {
+    }
+
+    virtual auto init() -> void override {
+    }
+
+    virtual auto isready() -> void override {
+    }
+
+    virtual auto newgame() -> void override {
+        std::fill(m_tt.begin(), m_tt.end(), TTEntry{});
+    }
+
+    virtual auto quit() -> void override {
+    }
+
+    virtual auto stop() -> void override {
+    }
+
+    virtual auto kill() -> void override {
+    }
+
+    virtual auto position(const libataxx::Position &pos) -> void override {
+        m_pos = pos;
+    }
+
+    virtual auto set_option(const std::string &, const std::string &) -> void override {
+    }
+
+    [[nodiscard]] virtual auto go(const SearchSettings &settings, const EngineClock::time_point deadline)
+        -> std::string override {
+        if (m_pos.is_gameover()) {
+            return "0000";
+        }
+
+        const auto t0 = EngineClock::now();
+        auto depth_limit = max_depth;
+        m_node_limit = std::numeric_limits<std::uint64_t>::max();
+        m_deadline = deadline;
+
+        switch (settings.type) {
+            case SearchSettings::Type::Depth:
+                depth_limit = std::clamp(settings.ply, 1, max_depth);
+                break;
+            case SearchSettings::Type::Nodes:
+                m_node_limit = static_cast<std::uint64_t>(std::max(settings.nodes, 1));
+                break;
+            case SearchSettings::Type::Movetime:
+                m_deadline = std::min(deadline, t0 + std::chrono::milliseconds(settings.movetime));
+                break;
+            case SearchSettings::Type::Time: {
+                const auto black = m_pos.get_turn() == libataxx::Side::Black;
+                const auto time = black ? settings.btime : settings.wtime;
+                const auto inc = black ? settings.binc : settings.winc;
+                m_deadline = std::min(deadline, t0 + std::chrono::milliseconds(time / 30 + inc / 2));
+                break;
+            }
+            default:
+                break;
+        }
+
+        m_nodes = 0;
+        m_stopped = false;
+
+        auto best_move = libataxx::Move::nullmove();
+        auto best_score = 0;
+        auto depth_reached = 0;
+
+        for (int depth = 1; depth <= depth_limit; ++depth) {
+            // The first iteration always finishes, so there's a move to play
+            m_can_stop = depth > 1;
+
+            const auto score = search(m_pos, depth, -mate_score, mate_score, 0);
+            if (m_stopped) {
+                break;
+            }
+
+            best_move = m_root_move;
+            best_score = score;
+            depth_reached = depth;
+
+            if (m_nodes >= m_node_limit || std::abs(score) > mate_score - max_depth) {
+                break;
+            }
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(EngineClock::now() - t0);
+
+        SearchInfo info;
+        info.depth = depth_reached;
+        info.time = static_cast<int>(elapsed.count());
+        info.nodes = m_nodes;
+        info.pv = static_cast<std::string>(best_move);
+        if (std::abs(best_score) > mate_score - max_depth) {
+            const auto plies = mate_score - std::abs(best_score);
+            info.score_type = SearchInfo::ScoreType::Mate;
+            info.score = best_score > 0 ? (plies + 1) / 2 : -(plies + 1) / 2;
+        } else {
+            info.score_type = SearchInfo::ScoreType::Cp;
+            info.score = best_score;
+        }
+        m_search_info = info;
+
+        return static_cast<std::string>(best_move);
+    }
+
+    [[nodiscard]] virtual auto is_running() -> bool override {
+        return true;
+    }
+
+   private:
+    enum class Bound : std::uint8_t
+    {
+        None = 0,
+        Exact,
+        Lower,
+        Upper,
+    };
+
+    struct TTEntry {
+        std::uint64_t hash = 0;
+        libataxx::Move move = libataxx::Move::nullmove();
+        std::int32_t score = 0;
+        std::int8_t depth = 0;
+        Bound bound = Bound::None;
+    };
+
+    // Scores from the side to move's point of view, 100 per stone
+    [[nodiscard]] static auto eval(const libataxx::Position &pos) noexcept -> int {
+        return 100 * (pos.get_us().count() - pos.get_them().count());
+    }
+
+    // Wins are scored so that quicker ones are preferred
+    [[nodiscard]] static auto terminal(const libataxx::Position &pos, const int ply) noexcept -> int {
+        switch (pos.get_result()) {
+            case libataxx::Result::BlackWin:
+                return pos.get_turn() == libataxx::Side::Black ? mate_score - ply : -mate_score + ply;
+            case libataxx::Result::WhiteWin:
+                return pos.get_turn() == libataxx::Side::White ? mate_score - ply : -mate_score + ply;
+            default:
+                return 0;
+        }
+    }
+
+    // Mate scores are stored relative to the position rather than the root
+    [[nodiscard]] static auto to_tt(const int score, const int ply) noexcept -> int {
+        if (score > mate_score - max_depth) {
+            return score + ply;
+        } else if (score < -mate_score + max_depth) {
+            return score - ply;
+        }
+        return score;
+    }
+
+    [[nodiscard]] static auto from_tt(const int score, const int ply) noexcept -> int {
+        if (score > mate_score - max_depth) {
+            return score - ply;
+        } else if (score < -mate_score + max_depth) {
+            return score + ply;
+        }
+        return score;
+    }
+
+    [[nodiscard]] auto should_stop() noexcept -> bool {
+        if (m_can_stop && !m_stopped) {
+            m_stopped = m_nodes >= m_node_limit || (m_nodes % 1024 == 0 && EngineClock::now() >= m_deadline);
+        }
+        return m_stopped;
+    }
+
+    [[nodiscard]] auto search(const libataxx::Position &pos, const int depth, int alpha, const int beta, const int ply)
+        -> int {
+        if (pos.is_gameover()) {
+            return terminal(pos, ply);
+        } else if (depth == 0 || ply >= max_depth) {
+            return eval(pos);
+        }
+
+        m_nodes++;
+        if (should_stop()) {
+            return 0;
+        }
+
+        const auto hash = pos.get_hash();
+        auto &entry = m_tt[hash % m_tt.size()];
+        auto tt_move = libataxx::Move::nullmove();
+
+        if (entry.hash == hash) {
+            tt_move = entry.move;
+
+            // Never cut at the root, it needs a move
+            if (ply > 0 && entry.depth >= depth) {
+                const auto score = from_tt(entry.score, ply);
+                if (entry.bound == Bound::Exact || (entry.bound == Bound::Lower && score >= beta) ||
+                    (entry.bound == Bound::Upper && score <= alpha)) {
+                    return score;
+                }
+            }
+        }
+
+        auto &moves = m_moves[ply];
+        generate_moves(pos, moves);
+
+        // Hash move first, then the moves that gain the most stones
+        std::array<int, max_moves> order;
+        for (std::size_t i = 0; i < moves.size(); ++i) {
+            const auto &move = moves[i];
+            order[i] = move == tt_move ? 1'000 : pos.count_captures(move) + move.is_single();
+        }
+
+        const auto alpha_orig = alpha;
+        auto best_score = -mate_score;
+        auto best_move = moves[0];
+
+        for (std::size_t i = 0; i < moves.size(); ++i) {
+            // Selection sort as we go, the later moves are rarely reached
+            const auto next = static_cast<std::size_t>(
+                std::max_element(order.begin() + i, order.begin() + moves.size()) - order.begin());
+            std::swap(order[i], order[next]);
+            moves.swap(i, next);
+
+            auto child = pos;
+            child.makemove(moves[i]);
+            const auto score = -search(child, depth - 1, -beta, -alpha, ply + 1);
+
+            if (m_stopped) {
+                return 0;
+            }
+
+            if (score > best_score) {
+                best_score = score;
+                best_move = moves[i];
+
+                if (ply == 0) {
+                    m_root_move = best_move;
+                }
+            }
+
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) {
+                break;
+            }
+        }
+
+        entry.hash = hash;
+        entry.move = best_move;
+        entry.score = to_tt(best_score, ply);
+        entry.depth = static_cast<std::int8_t>(depth);
+        entry.bound = best_score >= beta ? Bound::Lower : best_score <= alpha_orig ? Bound::Upper : Bound::Exact;
+
+        return best_score;
+    }
+
+    libataxx::Position m_pos;
+    std::vector<TTEntry> m_tt;
+    std::array<MoveList, max_depth> m_moves;
+    libataxx::Move m_root_move = libataxx::Move::nullmove();
+    EngineClock::time_point m_deadline;
+    std::uint64_t m_nodes = 0;
+    std::uint64_t m_node_limit = 0;
+    bool m_can_stop = false;
+    bool m_stopped = false;
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef BUILTIN_CAPTURES_HPP
+#define BUILTIN_CAPTURES_HPP
+
+#include <array>
+#include <cstddef>
+#include <libataxx/bitboard.hpp>
+#include <libataxx/move.hpp>
+#include <libataxx/position.hpp>
+#include <optional>
+
+// How many of their stones neighbour each square, for every square at once
+// The count is a four bit number stored a bit per bitboard, so each neighbour direction is one bitwise add
+class CaptureCounts {
+   public:
+    [[nodiscard]] explicit CaptureCounts(const libataxx::Bitboard them) noexcept {
+        add(them.north());
+        add(them.south());
+        add(them.east());
+        add(them.west());
+        add(them.north().east());
+        add(them.north().west());
+        add(them.south().east());
+        add(them.south().west());
+    }
+
+    // The squares that would capture exactly n stones
+    [[nodiscard]] auto equal(const int n) const noexcept -> libataxx::Bitboard {
+        auto mask = ~libataxx::Bitboard();
+        for (std::size_t i = 0; i < m_bits.size(); ++i) {
+            mask &= ((n >> i) & 1) ? m_bits[i] : ~m_bits[i];
+        }
+        return mask;
+    }
+
+   private:
+    auto add(const libataxx::Bitboard bb) noexcept -> void {
+        auto carry = bb;
+        for (auto &bit : m_bits) {
+            const auto next = bit & carry;
+            bit ^= carry;
+            carry = next;
+        }
+    }
+
+    std::array<libataxx::Bitboard, 4> m_bits;
+};
+
+// Every square a double move can reach, including those that another stone could reach with a single
+// Bitboard::doubles() leaves those out, as it works on the set of stones as a whole
+[[nodiscard]] inline auto double_targets(const libataxx::Bitboard us) noexcept -> libataxx::Bitboard {
+    const auto north2 = us.north().north();
+    const auto south2 = us.south().south();
+    const auto far = north2 | south2;
+    const auto column = far | us.north() | us | us.south();
+
+    return far | far.east() | far.west() | column.east().east() | column.west().west();
+}
+
+// Picks moves scored by num_captures + is_single, without generating the moves to score them one at a time
+class CaptureScores {
+   public:
+    static constexpr int max_score = 9;
+
+    [[nodiscard]] explicit CaptureScores(const libataxx::Position &pos) noexcept
+        : m_us(pos.get_us()),
+          m_counts(pos.get_them()),
+          m_singles(pos.get_us().singles() & pos.get_empty()),
+          m_doubles(double_targets(pos.get_us()) & pos.get_empty()) {
+    }
+
+    [[nodiscard]] auto can_move() const noexcept -> bool {
+        return static_cast<bool>(m_singles | m_doubles);
+    }
+
+    // The first move with the score in the order generate_moves() gives, so that ties go the same way
+    [[nodiscard]] auto find(const int score) const noexcept -> std::optional<libataxx::Move> {
+        if (score > 0) {
+            const auto singles = m_singles & m_counts.equal(score - 1);
+            if (singles) {
+                return libataxx::Move(*singles.begin());
+            }
+        }
+
+        const auto doubles = m_doubles & m_counts.equal(score);
+        if (!doubles) {
+            return {};
+        }
+
+        for (const auto from : m_us) {
+            const auto to = libataxx::Bitboard(from).doubles() & doubles;
+            if (to) {
+                return libataxx::Move(from, *to.begin());
+            }
+        }
+
+        return {};
+    }
+
+   private:
+    libataxx::Bitboard m_us;
+    CaptureCounts m_counts;
+    libataxx::Bitboard m_singles;
+    libataxx::Bitboard m_doubles;
+};
+
+#endif
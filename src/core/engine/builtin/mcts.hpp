@@ -0,0 +1,317 @@
+#ifndef BUILTIN_MCTS_HPP
+#define BUILTIN_MCTS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../../rng.hpp"
+#include "../engine.hpp"
+#include "movegen.hpp"
+
+// Monte-Carlo tree search, with each leaf scored by a batch of playouts that are played in lockstep
+// Playouts follow the same policy as MostCapturesBuiltin, with ties broken at random so the batch doesn't repeat
+// itself. Searches to a node count are deterministic for a given seed, where nodes are playouts.
+class MCTSBuiltin : public Engine {
+   public:
+    static constexpr std::size_t lanes = 8;
+    static constexpr int max_playout_plies = 200;
+    static constexpr std::uint64_t default_playouts = 10'000;
+    static constexpr std::size_t max_tree_size = std::size_t{1} << 21;
+
+    [[nodiscard]] MCTSBuiltin(std::function<void(const std::string &msg)> send = {},
+                              std::function<void(const std::string &msg)> recv = {})
+        : Engine(send, recv) {
+    }
+
+    virtual auto init() -> void override {
+    }
+
+    virtual auto isready() -> void override {
+    }
+
+    virtual auto newgame() -> void override {
+        m_rng = Rng(m_seed);
+    }
+
+    virtual auto quit() -> void override {
+    }
+
+    virtual auto stop() -> void override {
+    }
+
+    virtual auto kill() -> void override {
+    }
+
+    virtual auto position(const libataxx::Position &pos) -> void override {
+        m_pos = pos;
+    }
+
+    virtual auto set_option(const std::string &, const std::string &) -> void override {
+    }
+
+    virtual auto seed(const std::uint64_t seed) -> void override {
+        m_seed = seed;
+    }
+
+    [[nodiscard]] virtual auto go(const SearchSettings &settings, const EngineClock::time_point deadline)
+        -> std::string override {
+        if (m_pos.is_gameover()) {
+            return "0000";
+        }
+
+        const auto t0 = EngineClock::now();
+        auto playout_limit = default_playouts;
+        auto search_deadline = deadline;
+
+        switch (settings.type) {
+            case SearchSettings::Type::Nodes:
+                playout_limit = static_cast<std::uint64_t>(std::max(settings.nodes, 1));
+                break;
+            case SearchSettings::Type::Movetime:
+                playout_limit = std::numeric_limits<std::uint64_t>::max();
+                search_deadline = std::min(deadline, t0 + std::chrono::milliseconds(settings.movetime));
+                break;
+            case SearchSettings::Type::Time: {
+                const auto black = m_pos.get_turn() == libataxx::Side::Black;
+                const auto time = black ? settings.btime : settings.wtime;
+                const auto inc = black ? settings.binc : settings.winc;
+                playout_limit = std::numeric_limits<std::uint64_t>::max();
+                search_deadline = std::min(deadline, t0 + std::chrono::milliseconds(time / 30 + inc / 2));
+                break;
+            }
+            default:
+                break;
+        }
+
+        m_tree.clear();
+        m_tree.push_back(Node{});
+        m_blocked = ~(m_pos.get_empty() | m_pos.get_us() | m_pos.get_them());
+
+        std::uint64_t playouts = 0;
+        for (std::uint64_t i = 0; playouts < playout_limit; ++i) {
+            if (i > 0 && i % 16 == 0 && EngineClock::now() >= search_deadline) {
+                break;
+            }
+            iterate();
+            playouts += lanes;
+        }
+
+        // The most visited move is the one we're most sure of
+        const auto &root = m_tree[0];
+        auto best = root.first_child;
+        for (std::uint32_t i = root.first_child; i < root.first_child + root.num_children; ++i) {
+            if (m_tree[i].visits > m_tree[best].visits) {
+                best = i;
+            }
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(EngineClock::now() - t0);
+        const auto winrate = std::clamp(m_tree[best].wins / static_cast<float>(m_tree[best].visits), 0.001f, 0.999f);
+
+        SearchInfo info;
+        info.time = static_cast<int>(elapsed.count());
+        info.nodes = playouts;
+        info.score_type = SearchInfo::ScoreType::Cp;
+        info.score = static_cast<int>(std::lround(-400.0f * std::log10(1.0f / winrate - 1.0f)));
+        info.pv = static_cast<std::string>(m_tree[best].move);
+        m_search_info = info;
+
+        return static_cast<std::string>(m_tree[best].move);
+    }
+
+    [[nodiscard]] virtual auto is_running() -> bool override {
+        return true;
+    }
+
+   private:
+    // Wins are from the point of view of the side that played the move into the node, draws count as half
+    struct Node {
+        libataxx::Move move = libataxx::Move::nullmove();
+        std::uint32_t first_child = 0;
+        std::uint16_t num_children = 0;
+        std::uint32_t visits = 0;
+        float wins = 0.0f;
+    };
+
+    // UCT, trying every child once before revisiting any
+    [[nodiscard]] auto select(const std::uint32_t idx) const noexcept -> std::uint32_t {
+        const auto &parent = m_tree[idx];
+        const auto log_visits = std::log(static_cast<float>(parent.visits));
+        auto best = parent.first_child;
+        auto best_score = -1.0f;
+
+        for (std::uint32_t i = parent.first_child; i < parent.first_child + parent.num_children; ++i) {
+            const auto &child = m_tree[i];
+            if (child.visits == 0) {
+                return i;
+            }
+
+            const auto visits = static_cast<float>(child.visits);
+            const auto score = child.wins / visits + 1.4f * std::sqrt(log_visits / visits);
+            if (score > best_score) {
+                best_score = score;
+                best = i;
+            }
+        }
+
+        return best;
+    }
+
+    // Returns false once the tree's full, and the leaf gets scored by more playouts instead
+    [[nodiscard]] auto expand(const std::uint32_t idx, const libataxx::Position &pos) -> bool {
+        generate_moves(pos, m_moves);
+        if (m_tree.size() + m_moves.size() > max_tree_size) {
+            return false;
+        }
+
+        m_tree[idx].first_child = static_cast<std::uint32_t>(m_tree.size());
+        m_tree[idx].num_children = static_cast<std::uint16_t>(m_moves.size());
+        for (const auto &move : m_moves) {
+            m_tree.push_back(Node{move});
+        }
+        return true;
+    }
+
+    auto iterate() -> void {
+        auto pos = m_pos;
+        std::uint32_t idx = 0;
+        m_path.clear();
+        m_path.push_back(idx);
+
+        while (m_tree[idx].num_children > 0) {
+            idx = select(idx);
+            pos.makemove(m_tree[idx].move);
+            m_path.push_back(idx);
+        }
+
+        // Leaves only get children once they've been scored themselves
+        if (!pos.is_gameover() && (idx == 0 || m_tree[idx].visits > 0) && expand(idx, pos)) {
+            idx = m_tree[idx].first_child;
+            pos.makemove(m_tree[idx].move);
+            m_path.push_back(idx);
+        }
+
+        // Wins for the side to move in the leaf
+        auto wins = 0.0f;
+        if (pos.is_gameover()) {
+            const auto result = pos.get_result();
+            if (result == libataxx::Result::Draw) {
+                wins = 0.5f * lanes;
+            } else if ((result == libataxx::Result::BlackWin) == (pos.get_turn() == libataxx::Side::Black)) {
+                wins = lanes;
+            }
+        } else {
+            wins = playout(pos);
+        }
+
+        // Each node's wins belong to the side that moved into it, which is the other side from the one to move there
+        for (auto it = m_path.rbegin(); it != m_path.rend(); ++it) {
+            wins = lanes - wins;
+            m_tree[*it].visits += lanes;
+            m_tree[*it].wins += wins;
+        }
+    }
+
+    // Play out a batch of games from the position at once, one ply across every game at a time
+    // Returns the wins for the side to move
+    [[nodiscard]] auto playout(const libataxx::Position &pos) noexcept -> float {
+        std::array<libataxx::Bitboard, lanes> us;
+        std::array<libataxx::Bitboard, lanes> them;
+        std::array<libataxx::Bitboard, lanes> singles;
+        std::array<libataxx::Bitboard, lanes> reach;
+        std::array<bool, lanes> over;
+
+        us.fill(pos.get_us());
+        them.fill(pos.get_them());
+        over.fill(false);
+
+        int ply = 0;
+        for (; ply < max_playout_plies; ++ply) {
+            // The cheap part is the same for every game, so do it for all of them before picking moves
+            for (std::size_t i = 0; i < lanes; ++i) {
+                const auto empty = ~(us[i] | them[i] | m_blocked);
+                singles[i] = us[i].singles() & empty;
+                reach[i] = (us[i].singles() | us[i].doubles()) & empty;
+                over[i] = over[i] || !us[i] || !them[i] || !empty ||
+                          !(reach[i] | ((them[i].singles() | them[i].doubles()) & empty));
+            }
+
+            if (std::all_of(over.begin(), over.end(), [](const bool b) {
+                    return b;
+                })) {
+                break;
+            }
+
+            for (std::size_t i = 0; i < lanes; ++i) {
+                // Games that are over, or where the side to move has to pass, stay as they are
+                if (!over[i] && reach[i]) {
+                    play_most_captures(us[i], them[i], singles[i], reach[i]);
+                }
+            }
+
+            std::swap(us, them);
+        }
+
+        // After an odd number of plies, the side to move in pos is the one in them
+        if (ply % 2 == 1) {
+            std::swap(us, them);
+        }
+
+        auto wins = 0.0f;
+        for (std::size_t i = 0; i < lanes; ++i) {
+            const auto ours = us[i].count();
+            const auto theirs = them[i].count();
+            wins += ours > theirs ? 1.0f : ours == theirs ? 0.5f : 0.0f;
+        }
+        return wins;
+    }
+
+    // The move that maximises num_captures + is_single, like MostCapturesBuiltin
+    auto play_most_captures(libataxx::Bitboard &us,
+                            libataxx::Bitboard &them,
+                            const libataxx::Bitboard singles,
+                            const libataxx::Bitboard reach) noexcept -> void {
+        auto best_score = -1;
+        auto num_best = 0;
+        auto best_to = *reach.begin();
+
+        for (const auto to : reach) {
+            const auto is_single = static_cast<bool>(singles & libataxx::Bitboard(to));
+            const auto score = (libataxx::Bitboard(to).singles() & them).count() + is_single;
+            if (score > best_score) {
+                best_score = score;
+                best_to = to;
+                num_best = 1;
+            } else if (score == best_score && m_rng.below(static_cast<std::uint64_t>(++num_best)) == 0) {
+                best_to = to;
+            }
+        }
+
+        const auto to = libataxx::Bitboard(best_to);
+        const auto captured = to.singles() & them;
+        us |= to | captured;
+        them ^= captured;
+
+        // A double move has to leave from somewhere
+        if (!(singles & to)) {
+            us ^= libataxx::Bitboard(*(to.doubles() & us).begin());
+        }
+    }
+
+    libataxx::Position m_pos;
+    libataxx::Bitboard m_blocked;
+    std::vector<Node> m_tree;
+    std::vector<std::uint32_t> m_path;
+    MoveList m_moves;
+    std::uint64_t m_seed = 0;
+    Rng m_rng;
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include <functional>
 #include <string>
 #include "../engine.hpp"
+#include "captures.hpp"
 
 class MostCapturesBuiltin : public Engine {
    public:
@@ -27,6 +28,9 @@ class MostCapturesBuiltin : public Engine {
     virtual auto stop() -> void override {
     }
 
+    virtual auto kill() -> void override {
+    }
+
     virtual auto position(const libataxx::Position &pos) -> void override {
         m_pos = pos;
     }
@@ -34,24 +38,25 @@ class MostCapturesBuiltin : public Engine {
     virtual auto set_option(const std::string &, const std::string &) -> void override {
     }
 
-    [[nodiscard]] virtual auto go(const SearchSettings &) -> std::string override {
+    [[nodiscard]] virtual auto go(const SearchSettings &, const EngineClock::time_point) -> std::string override {
         if (m_pos.is_gameover()) {
             return "0000";
         }
 
-        const auto moves = m_pos.legal_moves();
-        auto best_score = -1;
-        auto best_move = libataxx::Move::nullmove();
+        return static_cast<std::string>(pick(m_pos));
+    }
+
+    // Also called directly when both players are builtins, see play_builtin()
+    [[nodiscard]] static auto pick(const libataxx::Position &pos) noexcept -> libataxx::Move {
+        const auto scores = CaptureScores(pos);
 
-        for (const auto &move : moves) {
-            const auto score = m_pos.count_captures(move) + move.is_single();
-            if (score > best_score) {
-                best_score = score;
-                best_move = move;
+        for (int score = CaptureScores::max_score; score >= 0 && scores.can_move(); --score) {
+            if (const auto move = scores.find(score)) {
+                return *move;
             }
         }
 
-        return static_cast<std::string>(best_move);
+        return libataxx::Move::nullmove();
     }
 
     [[nodiscard]] virtual auto is_running() -> bool override {
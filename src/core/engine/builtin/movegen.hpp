@@ -0,0 +1,76 @@
+#ifndef BUILTIN_MOVEGEN_HPP
+#define BUILTIN_MOVEGEN_HPP
+
+#include <array>
+#include <cstddef>
+#include <libataxx/bitboard.hpp>
+#include <libataxx/move.hpp>
+#include <libataxx/position.hpp>
+#include <utility>
+
+// Every empty square can be reached by at most one single and sixteen double moves
+constexpr std::size_t max_moves = 49 * 17;
+
+// Fixed size move list, so the builtins can pick their moves without allocating
+class MoveList {
+   public:
+    auto push(const libataxx::Move move) noexcept -> void {
+        m_moves[m_size++] = move;
+    }
+
+    auto swap(const std::size_t a, const std::size_t b) noexcept -> void {
+        std::swap(m_moves[a], m_moves[b]);
+    }
+
+    auto clear() noexcept -> void {
+        m_size = 0;
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return m_size;
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] auto operator[](const std::size_t idx) const noexcept -> const libataxx::Move & {
+        return m_moves[idx];
+    }
+
+    [[nodiscard]] auto begin() const noexcept {
+        return m_moves.begin();
+    }
+
+    [[nodiscard]] auto end() const noexcept {
+        return m_moves.begin() + m_size;
+    }
+
+   private:
+    std::array<libataxx::Move, max_moves> m_moves;
+    std::size_t m_size = 0;
+};
+
+// The legal moves in a position that isn't game over, in the same order as libataxx: singles, then doubles
+inline auto generate_moves(const libataxx::Position &pos, MoveList &moves) noexcept -> void {
+    moves.clear();
+
+    const auto empty = pos.get_empty();
+
+    for (const auto to : pos.get_us().singles() & empty) {
+        moves.push(libataxx::Move(to));
+    }
+
+    for (const auto from : pos.get_us()) {
+        for (const auto to : libataxx::Bitboard(from).doubles() & empty) {
+            moves.push(libataxx::Move(from, to));
+        }
+    }
+
+    // The side to move has to pass
+    if (moves.empty()) {
+        moves.push(libataxx::Move::nullmove());
+    }
+}
+
+#endif
@@ -1,9 +1,12 @@
 #ifndef BUILTIN_RANDOM_HPP
 #define BUILTIN_RANDOM_HPP
 
+#include <cstdint>
 #include <functional>
 #include <string>
+#include "../../rng.hpp"
 #include "../engine.hpp"
+#include "movegen.hpp"
 
 class RandomBuiltin : public Engine {
    public:
@@ -27,6 +30,9 @@ class RandomBuiltin : public Engine {
     virtual auto stop() -> void override {
     }
 
+    virtual auto kill() -> void override {
+    }
+
     virtual auto position(const libataxx::Position &pos) -> void override {
         m_pos = pos;
     }
@@ -34,14 +40,22 @@ class RandomBuiltin : public Engine {
     virtual auto set_option(const std::string &, const std::string &) -> void override {
     }
 
-    [[nodiscard]] virtual auto go(const SearchSettings &) -> std::string override {
+    virtual auto seed(const std::uint64_t seed) -> void override {
+        m_rng = Rng(seed);
+    }
+
+    [[nodiscard]] virtual auto go(const SearchSettings &, const EngineClock::time_point) -> std::string override {
         if (m_pos.is_gameover()) {
             return "0000";
         }
-        const auto moves = m_pos.legal_moves();
-        const auto idx = rand() % moves.size();
-        const auto move = moves.at(idx);
-        return static_cast<std::string>(move);
+        return static_cast<std::string>(pick(m_pos, m_moves, m_rng));
+    }
+
+    // Also called directly when both players are builtins, see play_builtin()
+    [[nodiscard]] static auto pick(const libataxx::Position &pos, MoveList &moves, Rng &rng) noexcept
+        -> libataxx::Move {
+        generate_moves(pos, moves);
+        return moves[rng.below(moves.size())];
     }
 
     [[nodiscard]] virtual auto is_running() -> bool override {
@@ -50,6 +64,8 @@ class RandomBuiltin : public Engine {
 
    private:
     libataxx::Position m_pos;
+    MoveList m_moves;
+    Rng m_rng;
 };
 
 #endif
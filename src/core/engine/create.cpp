@@ -1,28 +1,35 @@
 #include "create.hpp"
+#include "builtin/alphabeta.hpp"
 #include "builtin/least_captures.hpp"
+#include "builtin/mcts.hpp"
 #include "builtin/most_captures.hpp"
 #include "builtin/random.hpp"
 #include "engine.hpp"
 #include "fairy_stockfish.hpp"
 #include "katago.hpp"
+#include "plugin.hpp"
 #include "settings.hpp"
 #include "uaiengine.hpp"
 
 [[nodiscard]] auto make_engine(const EngineSettings &settings,
                                std::function<void(const std::string &msg)> send,
-                               std::function<void(const std::string &msg)> recv) -> std::shared_ptr<Engine> {
+                               std::function<void(const std::string &msg)> recv,
+                               std::function<void(const int fd)> err) -> std::shared_ptr<Engine> {
     std::shared_ptr<Engine> engine;
 
     if (settings.builtin.empty()) {
         switch (settings.proto) {
             case EngineProtocol::UAI:
-                engine = std::make_shared<UAIEngine>(settings.path, settings.arguments, send, recv);
+                engine = std::make_shared<UAIEngine>(settings.path, settings.arguments, send, recv, err);
                 break;
             case EngineProtocol::FSF:
-                engine = std::make_shared<FairyStockfish>(settings.path, settings.arguments, send, recv);
+                engine = std::make_shared<FairyStockfish>(settings.path, settings.arguments, send, recv, err);
                 break;
             case EngineProtocol::KataGo:
-                engine = std::make_shared<KataGo>(settings.path, settings.arguments, send, recv);
+                engine = std::make_shared<KataGo>(settings.path, settings.arguments, send, recv, err);
+                break;
+            case EngineProtocol::Plugin:
+                engine = std::make_shared<PluginEngine>(settings.path, send, recv);
                 break;
             default:
                 throw std::invalid_argument("Unknown engine protocol");
@@ -34,17 +41,17 @@
             engine = std::make_shared<MostCapturesBuiltin>(send, recv);
         } else if (settings.builtin == "leastcaptures") {
             engine = std::make_shared<LeastCapturesBuiltin>(send, recv);
+        } else if (settings.builtin == "alphabeta") {
+            engine = std::make_shared<AlphaBetaBuiltin>(send, recv);
+        } else if (settings.builtin == "mcts") {
+            engine = std::make_shared<MCTSBuiltin>(send, recv);
         } else {
             throw std::invalid_argument("Unknown engine builtin");
         }
     }
 
-    engine->init();
-    for (const auto &[key, val] : settings.options) {
-        engine->set_option(key, val);
-    }
-
-    engine->isready();
+    engine->send_init(settings.options);
+    engine->wait_init();
 
     return engine;
 }
@@ -6,8 +6,10 @@
 #include <string>
 #include "engine.hpp"
 
+// Builtin and plugin engines have no stderr of their own, so err is only used for engine processes
 [[nodiscard]] auto make_engine(const EngineSettings &settings,
                                std::function<void(const std::string &msg)> send = {},
-                               std::function<void(const std::string &msg)> recv = {}) -> std::shared_ptr<Engine>;
+                               std::function<void(const std::string &msg)> recv = {},
+                               std::function<void(const int fd)> err = {}) -> std::shared_ptr<Engine>;
 
 #endif
@@ -1,11 +1,39 @@
 #ifndef ENGINE_HPP
 #define ENGINE_HPP
 
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <libataxx/move.hpp>
 #include <libataxx/position.hpp>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
+#include "search_info.hpp"
 #include "settings.hpp"
 
+using EngineClock = std::chrono::steady_clock;
+
+class Engine;
+
+// Thrown when an engine fails to respond before its deadline and has to be killed
+// It isn't always the engine to move that times out, so the exception says which one it was
+class EngineTimeout : public std::runtime_error {
+   public:
+    [[nodiscard]] EngineTimeout(const Engine &engine, const std::string &msg)
+        : std::runtime_error(msg), m_engine(&engine) {
+    }
+
+    [[nodiscard]] auto engine() const noexcept -> const Engine & {
+        return *m_engine;
+    }
+
+   private:
+    const Engine *m_engine = nullptr;
+};
+
 class Engine {
    public:
     [[nodiscard]] Engine(std::function<void(const std::string &msg)> send = {},
@@ -16,12 +44,64 @@ class Engine {
     virtual ~Engine() {
     }
 
-    [[nodiscard]] virtual auto go(const SearchSettings &settings) -> std::string = 0;
+    [[nodiscard]] virtual auto go(const SearchSettings &settings,
+                                  const EngineClock::time_point deadline = EngineClock::time_point::max())
+        -> std::string = 0;
+
+    // Event driven searches: go_async() starts a search, then poll_go() is called whenever output_fd() is readable
+    // until it returns the move. Engines without output to wait on search synchronously by default.
+    virtual auto go_async(const SearchSettings &settings, const EngineClock::time_point deadline) -> void {
+        m_async_move = go(settings, deadline);
+    }
+
+    [[nodiscard]] virtual auto poll_go() -> std::optional<std::string> {
+        return std::exchange(m_async_move, std::nullopt);
+    }
+
+    [[nodiscard]] virtual auto output_fd() -> int {
+        return -1;
+    }
+
+    // Pondering: go_ponder() starts a search of the position after the reply the engine expects. If the reply gets
+    // played, ponderhit() turns that into the real search and go() only has to wait for the move. Otherwise
+    // stop_ponder() abandons it, without waiting on the engine. Engines that can't ponder never suggest a move to
+    // ponder.
+    virtual auto go_ponder(const SearchSettings &) -> void {
+    }
+
+    virtual auto ponderhit() -> void {
+    }
+
+    virtual auto stop_ponder() -> void {
+    }
 
     virtual auto init() -> void = 0;
 
+    // Startup in two halves, so that many engines can be started at once: send_init() sends the handshake and options
+    // without waiting on the engine, then wait_init() waits until it's ready to play
+    virtual auto send_init(const std::vector<std::pair<std::string, std::string>> &options) -> void {
+        init();
+        for (const auto &[name, value] : options) {
+            set_option(name, value);
+        }
+    }
+
+    virtual auto wait_init() -> void {
+        isready();
+    }
+
     virtual auto position(const libataxx::Position &pos) -> void = 0;
 
+    // Send the game as its starting position and the moves played since, so the engine can tell the game is carrying
+    // on. Engines that can't take a list of moves get the current position instead.
+    virtual auto position_moves(const libataxx::Position &startpos, const std::vector<libataxx::Move> &moves) -> void {
+        auto pos = startpos;
+        for (const auto &move : moves) {
+            pos.makemove(move);
+        }
+        position(pos);
+    }
+
     virtual auto set_option(const std::string &name, const std::string &value) -> void = 0;
 
     virtual auto isready() -> void = 0;
@@ -34,9 +114,35 @@ class Engine {
 
     virtual auto stop() -> void = 0;
 
+    virtual auto kill() -> void = 0;
+
+    // Engines that play at random take a seed from each game, so that the game can be replayed exactly. Called before
+    // newgame().
+    virtual auto seed(const std::uint64_t) -> void {
+    }
+
+    // Restrict the engine to the given logical CPUs. Builtin engines run on the calling thread so have nothing to pin.
+    virtual auto set_affinity(const std::vector<int> &) -> void {
+    }
+
+    // What the engine reported about its last search, if anything
+    [[nodiscard]] auto search_info() const noexcept -> const std::optional<SearchInfo> & {
+        return m_search_info;
+    }
+
+    // The reply the engine expected to its last move, if it said
+    [[nodiscard]] auto ponder_move() const noexcept -> const std::optional<std::string> & {
+        return m_ponder_move;
+    }
+
    protected:
     std::function<void(const std::string &msg)> m_send;
     std::function<void(const std::string &msg)> m_recv;
+    std::optional<SearchInfo> m_search_info;
+    std::optional<std::string> m_ponder_move;
+
+   private:
+    std::optional<std::string> m_async_move;
 };
 
 #endif
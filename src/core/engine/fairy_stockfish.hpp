@@ -1,10 +1,15 @@
 #ifndef FAIRY_STOCKFISH_ENGINE_PROCESS_HPP
 #define FAIRY_STOCKFISH_ENGINE_PROCESS_HPP
 
+#include <cstdint>
+#include <libataxx/move.hpp>
 #include <libataxx/position.hpp>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <utils.hpp>
+#include <vector>
 #include "process.hpp"
 
 [[nodiscard]] inline auto fen_to_fsf_fen(const std::string &fen) noexcept -> std::string {
@@ -36,34 +41,60 @@
     return nfen;
 }
 
+// Single moves are drops in Fairy-Stockfish
+[[nodiscard]] inline auto move_to_fsf_move(const libataxx::Move &move) -> std::string {
+    if (move.is_single()) {
+        return "P@" + static_cast<std::string>(move.to());
+    }
+    return static_cast<std::string>(move);
+}
+
 class FairyStockfish : public ProcessEngine {
    public:
     [[nodiscard]] FairyStockfish(const std::string &path,
                                  const std::string &arguments,
                                  std::function<void(const std::string &msg)> send = {},
-                                 std::function<void(const std::string &msg)> recv = {})
-        : ProcessEngine(path, arguments, send, recv) {
+                                 std::function<void(const std::string &msg)> recv = {},
+                                 std::function<void(const int fd)> err = {})
+        : ProcessEngine(path, arguments, send, recv, err) {
     }
 
     ~FairyStockfish() {
         if (is_running()) {
-            send("stop");
-            send("quit");
+            try {
+                send("stop");
+                send("quit");
+            } catch (...) {
+            }
         }
     }
 
     virtual auto init() -> void override {
         send("uci");
-        wait_for("uciok");
+        wait_for("uciok", response_deadline());
+    }
+
+    virtual auto send_init(const std::vector<std::pair<std::string, std::string>> &options) -> void override {
+        send("uci");
+        for (const auto &[name, value] : options) {
+            set_option(name, value);
+        }
+        send("isready");
+    }
+
+    virtual auto wait_init() -> void override {
+        wait_for("uciok", response_deadline());
+        wait_for("readyok", response_deadline());
     }
 
     virtual void isready() override {
         send("isready");
-        wait_for("readyok");
+        wait_for("readyok", response_deadline());
     }
 
     virtual void newgame() override {
         send("ucinewgame");
+        m_position.clear();
     }
 
     virtual void quit() override {
@@ -75,15 +106,65 @@ class FairyStockfish : public ProcessEngine {
     }
 
     virtual auto position(const libataxx::Position &pos) -> void override {
+        m_position.clear();
         const auto nfen = fen_to_fsf_fen(pos.get_fen());
-        send("position fen " + nfen);
+        send("position fen " + nfen, false);
+    }
+
+    virtual auto position_moves(const libataxx::Position &startpos, const std::vector<libataxx::Move> &moves)
+        -> void override {
+        // Passes can't be sent as moves, so start from the position after the last one instead
+        std::size_t first = 0;
+        for (std::size_t i = 0; i < moves.size(); ++i) {
+            if (moves[i] == libataxx::Move::nullmove()) {
+                first = i + 1;
+            }
+        }
+
+        // Later in the same game we only need to add the new moves to the last command
+        if (m_position.empty() || startpos.get_hash() != m_position_hash || first != m_position_first ||
+            moves.size() < m_position_moves) {
+            auto pos = startpos;
+            for (std::size_t i = 0; i < first; ++i) {
+                pos.makemove(moves[i]);
+            }
+
+            m_position = "position fen " + fen_to_fsf_fen(pos.get_fen());
+            m_position_hash = startpos.get_hash();
+            m_position_first = m_position_moves = first;
+        }
+
+        for (; m_position_moves < moves.size(); ++m_position_moves) {
+            m_position += m_position_moves == m_position_first ? " moves " : " ";
+            m_position += move_to_fsf_move(moves[m_position_moves]);
+        }
+
+        send(m_position, false);
     }
 
     virtual auto set_option(const std::string &name, const std::string &value) -> void override {
         send("setoption name " + name + " value " + value);
     }
 
-    [[nodiscard]] virtual auto go(const SearchSettings &settings) -> std::string override {
+    [[nodiscard]] virtual auto go(const SearchSettings &settings, const EngineClock::time_point deadline)
+        -> std::string override {
+        go_async(settings, deadline);
+
+        auto movestr = std::string("0000");
+
+        wait_for(
+            [this, &movestr](const std::string_view msg) {
+                return parse_output(msg, movestr);
+            },
+            deadline);
+
+        return movestr;
+    }
+
+    virtual auto go_async(const SearchSettings &settings, const EngineClock::time_point) -> void override {
+        m_search_info.reset();
+        m_info_line.clear();
+
         switch (settings.type) {
             case SearchSettings::Type::Time: {
                 auto str = std::string();
@@ -105,45 +186,53 @@ class FairyStockfish : public ProcessEngine {
                 send("go nodes " + std::to_string(settings.nodes));
                 break;
             default:
-                return {};
+                break;
         }
+    }
 
+    [[nodiscard]] virtual auto poll_go() -> std::optional<std::string> override {
         auto movestr = std::string("0000");
 
-        wait_for([&movestr](const std::string_view msg) {
-            const auto parts = utils::split(msg);
-            auto got_bestmove = false;
-
-            for (std::size_t i = 0; i < parts.size(); i += 2) {
-                if (parts[i] == "bestmove") {
-                    movestr = parts[i + 1];
-                    got_bestmove = true;
-                }
+        while (const auto line = get_output(EngineClock::now())) {
+            if (parse_output(*line, movestr)) {
+                return movestr;
             }
+        }
 
-            return got_bestmove;
-        });
-
-        return movestr;
+        return {};
     }
 
    private:
-    auto wait_for(const std::string &msg) -> void {
-        while (is_running()) {
-            const auto line = get_output();
-            if (line == msg) {
-                break;
+    // Returns true once the search is over, keeping hold of the last useful info line before then
+    [[nodiscard]] auto parse_output(const std::string_view msg, std::string &movestr) -> bool {
+        if (m_info_line.keep(msg)) {
+            return false;
+        }
+
+        const auto parts = utils::tokenize(msg);
+        auto got_bestmove = false;
+
+        for (std::size_t i = 0; i + 1 < parts.size(); i += 2) {
+            if (parts[i] == "bestmove") {
+                movestr = parts[i + 1];
+                got_bestmove = true;
             }
         }
-    }
 
-    auto wait_for(const std::function<bool(const std::string_view msg)> func) -> void {
-        auto exit = false;
-        while (is_running() && !exit) {
-            const auto line = get_output();
-            exit = func(line);
+        if (got_bestmove) {
+            m_search_info = m_info_line.parse();
+            m_info_line.clear();
         }
+
+        return got_bestmove;
     }
+
+    InfoLine m_info_line;
+    // The last position command sent with position_moves()
+    std::string m_position;
+    std::uint64_t m_position_hash = 0;
+    std::size_t m_position_first = 0;
+    std::size_t m_position_moves = 0;
 };
 
 #endif
@@ -12,22 +12,26 @@ class KataGo : public ProcessEngine {
     [[nodiscard]] KataGo(const std::string &path,
                          const std::string &arguments,
                          std::function<void(const std::string &msg)> send = {},
-                         std::function<void(const std::string &msg)> recv = {})
-        : ProcessEngine(path, arguments, send, recv) {
+                         std::function<void(const std::string &msg)> recv = {},
+                         std::function<void(const int fd)> err = {})
+        : ProcessEngine(path, arguments, send, recv, err) {
     }
 
     ~KataGo() {
         if (is_running()) {
-            send("quit");
-            wait_for_first("=");
+            try {
+                send("quit");
+                wait_for_first("=", response_deadline());
+            } catch (...) {
+            }
         }
     }
 
     virtual auto init() -> void override {
         send("boardsize 7");
-        wait_for_first("=");
+        wait_for_first("=", response_deadline());
         send("komi 0");
-        wait_for_first("=");
+        wait_for_first("=", response_deadline());
     }
 
     virtual void isready() override {
@@ -35,14 +39,14 @@ class KataGo : public ProcessEngine {
 
     virtual void newgame() override {
         send("clear_cache");
-        wait_for_first("=");
+        wait_for_first("=", response_deadline());
         send("clear_board");
-        wait_for_first("=");
+        wait_for_first("=", response_deadline());
     }
 
     virtual void quit() override {
         send("quit");
-        wait_for_first("=");
+        wait_for_first("=", response_deadline());
     }
 
     virtual void stop() override {
@@ -62,25 +66,26 @@ class KataGo : public ProcessEngine {
         }
 
         send(command);
-        wait_for_first("=");
+        wait_for_first("=", response_deadline());
     }
 
     virtual auto set_option(const std::string &name, const std::string &value) -> void override {
     }
 
-    [[nodiscard]] virtual auto go(const SearchSettings &settings) -> std::string override {
+    [[nodiscard]] virtual auto go(const SearchSettings &settings, const EngineClock::time_point deadline)
+        -> std::string override {
         switch (settings.type) {
             case SearchSettings::Type::Time: {
                 const auto time = static_cast<float>(m_is_black ? settings.btime : settings.wtime) / 1000;
                 const auto inc = static_cast<float>(m_is_black ? settings.binc : settings.winc) / 1000;
                 send("kata-time_settings fischer " + std::to_string(time) + " " + std::to_string(inc));
-                wait_for_first("=");
+                wait_for_first("=", response_deadline());
                 break;
             }
             case SearchSettings::Type::Movetime: {
                 const auto seconds = static_cast<float>(settings.movetime) / 1000;
                 send("time_settings 0 " + std::to_string(seconds) + " 1");
-                wait_for_first("=");
+                wait_for_first("=", response_deadline());
                 break;
             }
             case SearchSettings::Type::Depth:
@@ -93,31 +98,35 @@ class KataGo : public ProcessEngine {
 
         send("genmove");
         auto fromstr = std::string("0000");
-        wait_for([&fromstr](const std::string_view msg) {
-            const auto parts = utils::split(msg);
-            auto got_bestmove = false;
-            for (std::size_t i = 0; i + 1 < parts.size(); i += 2) {
-                if (parts[i] == "=") {
-                    fromstr = parts[i + 1];
-                    got_bestmove = true;
+        wait_for(
+            [&fromstr](const std::string_view msg) {
+                const auto parts = utils::tokenize(msg);
+                auto got_bestmove = false;
+                for (std::size_t i = 0; i + 1 < parts.size(); i += 2) {
+                    if (parts[i] == "=") {
+                        fromstr = parts[i + 1];
+                        got_bestmove = true;
+                    }
                 }
-            }
-            return got_bestmove;
-        });
+                return got_bestmove;
+            },
+            deadline);
 
         send("genmove");
         auto tostr = std::string("0000");
-        wait_for([&tostr](const std::string_view msg) {
-            const auto parts = utils::split(msg);
-            auto got_bestmove = false;
-            for (std::size_t i = 0; i + 1 < parts.size(); i += 2) {
-                if (parts[i] == "=") {
-                    tostr = parts[i + 1];
-                    got_bestmove = true;
+        wait_for(
+            [&tostr](const std::string_view msg) {
+                const auto parts = utils::tokenize(msg);
+                auto got_bestmove = false;
+                for (std::size_t i = 0; i + 1 < parts.size(); i += 2) {
+                    if (parts[i] == "=") {
+                        tostr = parts[i + 1];
+                        got_bestmove = true;
+                    }
                 }
-            }
-            return got_bestmove;
-        });
+                return got_bestmove;
+            },
+            deadline);
 
         if (fromstr == "pass") {
             return tostr;
@@ -131,35 +140,13 @@ class KataGo : public ProcessEngine {
     }
 
    private:
-    auto wait_for_first(const std::string &msg) -> void {
-        while (is_running()) {
-            const auto line = get_output();
-            if (line.empty()) {
-                continue;
-            }
-
-            const auto parts = utils::split(msg);
-            if (!parts.empty() && parts[0] == msg) {
-                break;
-            }
-        }
-    }
-
-    auto wait_for(const std::string &msg) -> void {
-        while (is_running()) {
-            const auto line = get_output();
-            if (line == msg) {
-                break;
-            }
-        }
-    }
-
-    auto wait_for(const std::function<bool(const std::string_view msg)> func) -> void {
-        auto exit = false;
-        while (is_running() && !exit) {
-            const auto line = get_output();
-            exit = func(line);
-        }
+    auto wait_for_first(const std::string &msg, const EngineClock::time_point deadline) -> void {
+        wait_for(
+            [&msg](const std::string_view line) {
+                const auto parts = utils::tokenize(line);
+                return !parts.empty() && parts[0] == msg;
+            },
+            deadline);
     }
 
     bool m_is_black = true;
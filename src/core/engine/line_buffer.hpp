@@ -0,0 +1,70 @@
+#ifndef ENGINE_LINE_BUFFER_HPP
+#define ENGINE_LINE_BUFFER_HPP
+
+#include <unistd.h>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+// Fixed size buffer for reading lines from a pipe without allocating
+// Lines are handed out as views into the buffer, which stay valid until the next fill()
+class LineBuffer {
+   public:
+    static constexpr std::size_t capacity = 64 * 1024;
+
+    // The next complete line, without its line ending
+    // A line that doesn't fit in the buffer is split into capacity sized pieces
+    [[nodiscard]] auto next_line() noexcept -> std::optional<std::string_view> {
+        const auto first = m_data.data() + m_head;
+        const auto last = m_data.data() + m_tail;
+        const auto newline = static_cast<const char *>(std::memchr(m_data.data() + m_scan, '\n', m_tail - m_scan));
+
+        if (newline == nullptr) {
+            m_scan = m_tail;
+
+            if (m_head == 0 && m_tail == capacity) {
+                m_head = m_scan = m_tail = 0;
+                return std::string_view(first, last - first);
+            }
+
+            return {};
+        }
+
+        m_head = m_scan = static_cast<std::size_t>(newline - m_data.data()) + 1;
+
+        auto line = std::string_view(first, newline - first);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        return line;
+    }
+
+    // Read whatever is available from the file descriptor, returning the number of bytes read like read() does
+    [[nodiscard]] auto fill(const int fd) noexcept -> ssize_t {
+        if (m_head == m_tail) {
+            m_head = m_scan = m_tail = 0;
+        } else if (m_tail == capacity) {
+            // Move the partial line at the end back to the start to make room
+            std::memmove(m_data.data(), m_data.data() + m_head, m_tail - m_head);
+            m_tail -= m_head;
+            m_scan -= m_head;
+            m_head = 0;
+        }
+
+        const auto n = read(fd, m_data.data() + m_tail, capacity - m_tail);
+        if (n > 0) {
+            m_tail += static_cast<std::size_t>(n);
+        }
+        return n;
+    }
+
+   private:
+    std::array<char, capacity> m_data;
+    // Unread data is [m_head, m_tail), with no newlines in [m_head, m_scan)
+    std::size_t m_head = 0;
+    std::size_t m_scan = 0;
+    std::size_t m_tail = 0;
+};
+
+#endif
@@ -0,0 +1,180 @@
+#include "log.hpp"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+
+EngineLog::EngineLog(const std::filesystem::path &dir, const std::size_t max_size, const std::size_t max_queued)
+    : m_dir(dir),
+      m_max_size(max_size),
+      m_max_queued(max_queued),
+      m_epoll(epoll_create1(EPOLL_CLOEXEC)),
+      m_wake(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+    if (m_epoll == -1 || m_wake == -1) {
+        close(m_epoll);
+        close(m_wake);
+        throw std::runtime_error("Failed to set up engine logs");
+    }
+
+    // Sources are identified by their pointer, so the wakeup is the one without
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &event);
+
+    std::filesystem::create_directories(m_dir);
+
+    m_thread = std::thread(&EngineLog::run, this);
+}
+
+EngineLog::~EngineLog() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const auto n = ::write(m_wake, &one, sizeof(one));
+    m_thread.join();
+
+    for (const auto &[fd, source] : m_sources) {
+        close(fd);
+    }
+    close(m_wake);
+    close(m_epoll);
+}
+
+auto EngineLog::write(const std::string &engine, std::string line) -> void {
+    auto was_empty = false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_queue.size() >= m_max_queued) {
+            m_dropped++;
+            return;
+        }
+
+        was_empty = m_queue.empty();
+        m_queue.emplace_back(engine, std::move(line));
+    }
+
+    // The writer empties the whole queue once woken, so it only needs waking for the first line
+    if (was_empty) {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const auto n = ::write(m_wake, &one, sizeof(one));
+    }
+}
+
+auto EngineLog::capture(const std::string &engine, const int fd) -> void {
+    auto source = std::make_unique<Source>();
+    source->engine = engine;
+    source->fd = fd;
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = source.get();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) == -1) {
+        close(fd);
+        throw std::runtime_error("Failed to capture engine output");
+    }
+    m_sources.emplace(fd, std::move(source));
+}
+
+auto EngineLog::path(const std::string &engine) const -> std::filesystem::path {
+    auto filename = engine;
+    std::replace(filename.begin(), filename.end(), '/', '_');
+    return m_dir / (filename + ".log");
+}
+
+auto EngineLog::run() -> void {
+    std::deque<std::pair<std::string, std::string>> lines;
+    auto stopping = false;
+
+    while (true) {
+        // Once stopping, keep going only for as long as there's something left to read
+        epoll_event events[16];
+        const auto num_ready = epoll_wait(m_epoll, events, 16, stopping ? 0 : -1);
+        if (num_ready < 0 && errno != EINTR) {
+            break;
+        }
+
+        for (int i = 0; i < num_ready; ++i) {
+            if (events[i].data.ptr == nullptr) {
+                std::uint64_t count;
+                [[maybe_unused]] const auto n = read(m_wake, &count, sizeof(count));
+                continue;
+            }
+
+            auto &source = *static_cast<Source *>(events[i].data.ptr);
+            if (!drain(source)) {
+                epoll_ctl(m_epoll, EPOLL_CTL_DEL, source.fd, nullptr);
+                close(source.fd);
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_sources.erase(source.fd);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            lines.swap(m_queue);
+            stopping = m_stop;
+        }
+
+        for (const auto &[engine, line] : lines) {
+            append(engine, line);
+        }
+
+        if (stopping && num_ready == 0 && lines.empty()) {
+            break;
+        }
+
+        lines.clear();
+
+        // Keep the files up to date whenever we've caught up
+        for (auto &[engine, file] : m_files) {
+            file.stream.flush();
+        }
+    }
+
+    for (auto &[engine, file] : m_files) {
+        file.stream.flush();
+    }
+}
+
+[[nodiscard]] auto EngineLog::drain(Source &source) -> bool {
+    const auto n = source.buffer.fill(source.fd);
+    if (n < 0) {
+        return errno == EINTR || errno == EAGAIN;
+    }
+
+    while (const auto line = source.buffer.next_line()) {
+        append(source.engine, *line);
+    }
+
+    return n > 0;
+}
+
+auto EngineLog::append(const std::string &engine, const std::string_view line) -> void {
+    auto &file = m_files[engine];
+
+    if (!file.stream.is_open()) {
+        file.stream.open(path(engine), std::ofstream::trunc);
+    } else if (file.size > 0 && file.size + line.size() + 1 > m_max_size) {
+        file.stream.close();
+        std::error_code ec;
+        std::filesystem::rename(path(engine), path(engine).string() + ".1", ec);
+        file.stream.open(path(engine), std::ofstream::trunc);
+        file.size = 0;
+    }
+
+    file.stream << line << '\n';
+    file.size += line.size() + 1;
+}
@@ -0,0 +1,83 @@
+#ifndef ENGINE_LOG_HPP
+#define ENGINE_LOG_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include "line_buffer.hpp"
+
+// Writes engine stderr and protocol traffic to a log file per engine from a background thread,
+// so games are never held up by disk or terminal output
+// A log that grows past the size limit is moved to "<name>.log.1", replacing the one before it
+class EngineLog {
+   public:
+    static constexpr std::size_t default_max_queued = 64 * 1024;
+
+    [[nodiscard]] EngineLog(const std::filesystem::path &dir,
+                            const std::size_t max_size,
+                            const std::size_t max_queued = default_max_queued);
+
+    // Anything still queued or waiting to be read is written out first
+    ~EngineLog();
+
+    EngineLog(const EngineLog &) = delete;
+    auto operator=(const EngineLog &) -> EngineLog & = delete;
+
+    // Queue a line for the engine's log
+    // The line is dropped if the writer has fallen too far behind, rather than waiting for it
+    auto write(const std::string &engine, std::string line) -> void;
+
+    // Copy lines from the file descriptor into the engine's log until it's closed, taking ownership of it
+    auto capture(const std::string &engine, const int fd) -> void;
+
+    [[nodiscard]] auto num_dropped() const noexcept -> std::size_t {
+        return m_dropped;
+    }
+
+    [[nodiscard]] auto path(const std::string &engine) const -> std::filesystem::path;
+
+   private:
+    struct Source {
+        std::string engine;
+        int fd = -1;
+        LineBuffer buffer;
+    };
+
+    struct File {
+        std::ofstream stream;
+        std::size_t size = 0;
+    };
+
+    auto run() -> void;
+
+    // Returns false once there's nothing more to read
+    [[nodiscard]] auto drain(Source &source) -> bool;
+
+    auto append(const std::string &engine, const std::string_view line) -> void;
+
+    std::filesystem::path m_dir;
+    std::size_t m_max_size = 0;
+    std::size_t m_max_queued = 0;
+    int m_epoll = -1;
+    int m_wake = -1;
+    std::atomic<std::size_t> m_dropped = 0;
+    // Shared with the writer thread
+    std::mutex m_mutex;
+    std::deque<std::pair<std::string, std::string>> m_queue;
+    std::map<int, std::unique_ptr<Source>> m_sources;
+    bool m_stop = false;
+    // Only used by the writer thread
+    std::map<std::string, File> m_files;
+    std::thread m_thread;
+};
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef ENGINE_PLUGIN_HPP
+#define ENGINE_PLUGIN_HPP
+
+#include <dlfcn.h>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <libataxx/position.hpp>
+#include <stdexcept>
+#include <string>
+#include "engine.hpp"
+#include "plugin_api.h"
+
+// An engine loaded from a shared library implementing plugin_api.h
+// Searches are a function call on the calling thread rather than a round trip through a pipe to another process
+class PluginEngine : public Engine {
+   public:
+    [[nodiscard]] PluginEngine(const std::string &path,
+                               std::function<void(const std::string &msg)> send = {},
+                               std::function<void(const std::string &msg)> recv = {})
+        : Engine(send, recv), m_library(dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL)) {
+        if (!m_library) {
+            throw std::runtime_error("Failed to load engine plugin: " + std::string(dlerror()));
+        }
+
+        try {
+            const auto version = symbol<decltype(cuteataxx_plugin_version)>("cuteataxx_plugin_version");
+            if (version() != CUTEATAXX_PLUGIN_VERSION) {
+                throw std::runtime_error("Engine plugin has the wrong version: " + path);
+            }
+
+            m_create = symbol<decltype(cuteataxx_create)>("cuteataxx_create");
+            m_destroy = symbol<decltype(cuteataxx_destroy)>("cuteataxx_destroy");
+            m_set_option = symbol<decltype(cuteataxx_set_option)>("cuteataxx_set_option");
+            m_newgame = symbol<decltype(cuteataxx_newgame)>("cuteataxx_newgame");
+            m_position = symbol<decltype(cuteataxx_position)>("cuteataxx_position");
+            m_go = symbol<decltype(cuteataxx_go)>("cuteataxx_go");
+
+            m_engine = m_create();
+            if (!m_engine) {
+                throw std::runtime_error("Engine plugin failed to create an engine: " + path);
+            }
+        } catch (...) {
+            dlclose(m_library);
+            throw;
+        }
+    }
+
+    ~PluginEngine() {
+        m_destroy(m_engine);
+        dlclose(m_library);
+    }
+
+    PluginEngine(const PluginEngine &) = delete;
+    auto operator=(const PluginEngine &) -> PluginEngine & = delete;
+
+    virtual auto init() -> void override {
+    }
+
+    virtual auto isready() -> void override {
+    }
+
+    virtual auto newgame() -> void override {
+        if (m_newgame(m_engine) != 0) {
+            throw std::runtime_error("Engine plugin failed to start a new game");
+        }
+    }
+
+    virtual auto quit() -> void override {
+    }
+
+    virtual auto stop() -> void override {
+    }
+
+    virtual auto kill() -> void override {
+    }
+
+    virtual auto position(const libataxx::Position &pos) -> void override {
+        const auto fen = pos.get_fen();
+        if (m_send) {
+            m_send("position fen " + fen);
+        }
+
+        if (m_position(m_engine, fen.c_str()) != 0) {
+            throw std::runtime_error("Engine plugin failed to set the position");
+        }
+    }
+
+    virtual auto set_option(const std::string &name, const std::string &value) -> void override {
+        if (m_send) {
+            m_send("setoption name " + name + " value " + value);
+        }
+
+        if (m_set_option(m_engine, name.c_str(), value.c_str()) != 0) {
+            throw std::runtime_error("Engine plugin failed to set option " + name);
+        }
+    }
+
+    [[nodiscard]] virtual auto go(const SearchSettings &settings, const EngineClock::time_point) -> std::string override {
+        const auto search = cuteataxx_search{
+            .type = static_cast<int>(settings.type),
+            .btime = settings.btime,
+            .wtime = settings.wtime,
+            .binc = settings.binc,
+            .winc = settings.winc,
+            .movetime = settings.movetime,
+            .depth = settings.ply,
+            .nodes = settings.nodes,
+        };
+
+        if (m_send) {
+            m_send("go");
+        }
+
+        std::array<char, 16> move{};
+        if (m_go(m_engine, &search, move.data(), move.size()) != 0) {
+            throw std::runtime_error("Engine plugin failed to search");
+        }
+        move.back() = '\0';
+
+        auto movestr = std::string(move.data());
+        if (m_recv) {
+            m_recv("bestmove " + movestr);
+        }
+        return movestr;
+    }
+
+    [[nodiscard]] virtual auto is_running() -> bool override {
+        return true;
+    }
+
+   private:
+    template <typename F>
+    [[nodiscard]] auto symbol(const char *name) -> F * {
+        const auto ptr = dlsym(m_library, name);
+        if (!ptr) {
+            throw std::runtime_error(std::string("Engine plugin is missing ") + name);
+        }
+        return reinterpret_cast<F *>(ptr);
+    }
+
+    void *m_library = nullptr;
+    void *m_engine = nullptr;
+    decltype(cuteataxx_create) *m_create = nullptr;
+    decltype(cuteataxx_destroy) *m_destroy = nullptr;
+    decltype(cuteataxx_set_option) *m_set_option = nullptr;
+    decltype(cuteataxx_newgame) *m_newgame = nullptr;
+    decltype(cuteataxx_position) *m_position = nullptr;
+    decltype(cuteataxx_go) *m_go = nullptr;
+};
+
+// Search types are passed straight through
+static_assert(static_cast<int>(SearchSettings::Type::Time) == CUTEATAXX_SEARCH_TIME);
+static_assert(static_cast<int>(SearchSettings::Type::Movetime) == CUTEATAXX_SEARCH_MOVETIME);
+static_assert(static_cast<int>(SearchSettings::Type::Depth) == CUTEATAXX_SEARCH_DEPTH);
+static_assert(static_cast<int>(SearchSettings::Type::Nodes) == CUTEATAXX_SEARCH_NODES);
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef CUTEATAXX_PLUGIN_API_H
+#define CUTEATAXX_PLUGIN_API_H
+
+/*
+ * The C interface for engines loaded into cuteataxx as shared libraries, with the "plugin" protocol.
+ *
+ * A plugin exports each of the functions below. Every game gets its own engine instance from cuteataxx_create(),
+ * and several instances may be used at once from different threads. Functions returning int return 0 on success.
+ *
+ * Plugins run inside cuteataxx itself, so a plugin that crashes takes the whole match down with it.
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CUTEATAXX_PLUGIN_VERSION 1
+
+enum cuteataxx_search_type
+{
+    CUTEATAXX_SEARCH_TIME = 0,
+    CUTEATAXX_SEARCH_MOVETIME = 1,
+    CUTEATAXX_SEARCH_DEPTH = 2,
+    CUTEATAXX_SEARCH_NODES = 3,
+};
+
+/* Only the fields for the search type are set, times are in milliseconds */
+struct cuteataxx_search {
+    int type;
+    int btime;
+    int wtime;
+    int binc;
+    int winc;
+    int movetime;
+    int depth;
+    int nodes;
+};
+
+/* Must return CUTEATAXX_PLUGIN_VERSION */
+int cuteataxx_plugin_version(void);
+
+/* A new engine instance, or NULL on failure */
+void *cuteataxx_create(void);
+
+void cuteataxx_destroy(void *engine);
+
+int cuteataxx_set_option(void *engine, const char *name, const char *value);
+
+int cuteataxx_newgame(void *engine);
+
+int cuteataxx_position(void *engine, const char *fen);
+
+/* Search the last position given, and write the move to play into move as a null terminated string like "b2",
+ * "a1c3" or "0000". The search must finish within the time it's given, as it can't be interrupted. */
+int cuteataxx_go(void *engine, const struct cuteataxx_search *search, char *move, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef ENGINE_POOL_HPP
+#define ENGINE_POOL_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "engine.hpp"
+
+// Idle engines shared between all the workers, so a process can be reused by whichever worker needs it next
+class EnginePool {
+   public:
+    [[nodiscard]] EnginePool(const std::size_t max_idle) : m_max_idle(max_idle) {
+    }
+
+    // Take an idle engine with the given id, or nothing if there isn't a healthy one
+    // Engines are checked with isready, unless the caller can't wait on them, in which case only engines that have
+    // exited are turned away
+    [[nodiscard]] auto checkout(const int id, const bool wait = true) -> std::shared_ptr<Engine> {
+        while (true) {
+            std::shared_ptr<Engine> engine;
+
+            {
+                std::lock_guard lock(m_mutex);
+
+                const auto iter = std::find_if(m_idle.rbegin(), m_idle.rend(), [id](const auto &obj) {
+                    return obj.first == id;
+                });
+
+                if (iter == m_idle.rend()) {
+                    return {};
+                }
+
+                engine = std::move(iter->second);
+                m_idle.erase(std::next(iter).base());
+            }
+
+            // Check the engine is still responsive without holding up the other workers
+            if (is_healthy(*engine, wait)) {
+                return engine;
+            }
+        }
+    }
+
+    // Return an engine after use, evicting the longest idle engine if there are too many
+    auto checkin(const int id, std::shared_ptr<Engine> engine) -> void {
+        assert(engine);
+
+        // Engines that were killed can't be reused
+        if (!engine->is_running()) {
+            return;
+        }
+
+        // Evicted engines are shut down once we've let go of the lock
+        std::shared_ptr<Engine> evicted;
+
+        {
+            std::lock_guard lock(m_mutex);
+
+            if (m_max_idle == 0) {
+                return;
+            }
+
+            if (m_idle.size() >= m_max_idle) {
+                evicted = std::move(m_idle.front().second);
+                m_idle.erase(m_idle.begin());
+            }
+
+            m_idle.emplace_back(id, std::move(engine));
+        }
+    }
+
+    [[nodiscard]] auto num_idle() -> std::size_t {
+        std::lock_guard lock(m_mutex);
+        return m_idle.size();
+    }
+
+   private:
+    [[nodiscard]] static auto is_healthy(Engine &engine, const bool wait) noexcept -> bool {
+        try {
+            if (!engine.is_running()) {
+                return false;
+            }
+
+            if (!wait) {
+                return true;
+            }
+
+            engine.isready();
+
+            return engine.is_running();
+        } catch (...) {
+            return false;
+        }
+    }
+
+    std::mutex m_mutex;
+    std::size_t m_max_idle = 0;
+    // Oldest first
+    std::vector<std::pair<int, std::shared_ptr<Engine>>> m_idle;
+};
+
+#endif
@@ -1,48 +1,91 @@
 #ifndef ENGINE_PROCESS_HPP
 #define ENGINE_PROCESS_HPP
 
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <algorithm>
 #include <boost/process.hpp>
+#include <cerrno>
+#include <chrono>
 #include <filesystem>
 #include <functional>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
+#include "../affinity.hpp"
 #include "engine.hpp"
+#include "line_buffer.hpp"
 
 class ProcessEngine : public Engine {
    public:
-    auto kill() -> void {
+    // How long an engine gets to answer "stop" after missing a deadline before it is killed
+    static constexpr auto grace_period = std::chrono::milliseconds(1000);
+
+    // Deadline for responses that don't depend on the time control, e.g. "uaiok" or "readyok"
+    static constexpr auto response_timeout = std::chrono::milliseconds(60'000);
+
+    virtual auto kill() -> void override {
         if (is_running()) {
             m_child.terminate();
-            m_in.close();
-            m_out.close();
+            close_streams();
             m_child.wait();
         }
     }
 
+    virtual auto set_affinity(const std::vector<int> &cpus) -> void override {
+        if (is_running()) {
+            pin_process(m_child.id(), cpus);
+        }
+    }
+
    protected:
+    // If err is set, it's given the read end of a pipe carrying the engine's stderr, which it then owns
+    // Otherwise the engine shares our stderr
     [[nodiscard]] ProcessEngine(const std::string &path,
                                 const std::string &arguments,
                                 std::function<void(const std::string &msg)> send = {},
-                                std::function<void(const std::string &msg)> recv = {})
+                                std::function<void(const std::string &msg)> recv = {},
+                                std::function<void(const int fd)> err = {})
         : Engine(send, recv),
-          m_child(path + (arguments.empty() ? "" : (" " + arguments)),
-                  boost::process::start_dir(std::filesystem::path(path).parent_path().string()),
-                  boost::process::std_out > m_out,
-                  boost::process::std_in < m_in) {
+          m_in(make_pipe()),
+          m_out(make_pipe()),
+          m_child(spawn(path, arguments, err)),
+          m_epoll(epoll_create1(EPOLL_CLOEXEC)) {
+        if (m_epoll == -1) {
+            throw std::runtime_error("Failed to create epoll instance");
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = m_out.pipe().native_source();
+        if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, event.data.fd, &event) == -1) {
+            close(m_epoll);
+            throw std::runtime_error("Failed to watch engine output");
+        }
     }
 
     virtual ~ProcessEngine() {
-        if (is_running()) {
-            m_in.close();
-            m_out.close();
+        const auto running = is_running();
+        close_streams();
+        if (running) {
             m_child.wait();
         }
+        close(m_epoll);
     }
 
     [[nodiscard]] virtual auto is_running() -> bool override {
         return m_child.running();
     }
 
-    auto send(const std::string &msg) -> void {
+    [[nodiscard]] virtual auto output_fd() -> int override {
+        return m_out.pipe().native_source();
+    }
+
+    // Unflushed messages go out along with the next flushed one, so several commands can share a single write
+    auto send(const std::string &msg, const bool flush = true) -> void {
         if (m_send) {
             m_send(msg);
         }
@@ -50,27 +93,149 @@ class ProcessEngine : public Engine {
 #ifdef _WIN32
         m_in << "\r";
 #endif
-        m_in << std::endl;
+        m_in << '\n';
+        if (flush) {
+            m_in.flush();
+        }
     }
 
-    [[nodiscard]] auto get_output() -> std::string {
-        std::string line;
-        std::getline(m_out, line);
-#ifdef _WIN32
-        if (line.back() == '\r') {
-            line.pop_back();
+    // Read the next line, or nothing if the deadline passes first
+    // The line is only valid until the next call
+    [[nodiscard]] auto get_output(const EngineClock::time_point deadline) -> std::optional<std::string_view> {
+        while (true) {
+            if (const auto line = m_buffer.next_line()) {
+                if (m_recv) {
+                    m_recv(std::string(*line));
+                }
+                return line;
+            }
+
+            if (!wait_readable(deadline)) {
+                return {};
+            }
+
+            const auto n = m_buffer.fill(m_out.pipe().native_source());
+            if (n == 0) {
+                throw std::runtime_error("Engine closed its output");
+            } else if (n < 0 && errno != EINTR && errno != EAGAIN) {
+                throw std::runtime_error("Failed to read engine output");
+            }
         }
-#endif
-        if (m_recv) {
-            m_recv(line);
+    }
+
+    // Read lines until one matches exactly
+    auto wait_for(const std::string &msg, const EngineClock::time_point deadline) -> void {
+        wait_for(
+            [&msg](const std::string_view line) {
+                return line == msg;
+            },
+            deadline);
+    }
+
+    // Read lines until the function returns true
+    // Past the deadline the engine is told to stop, then killed if it still hasn't finished after the grace period
+    auto wait_for(const std::function<bool(const std::string_view msg)> &func, const EngineClock::time_point deadline)
+        -> void {
+        auto limit = deadline;
+        auto stopped = false;
+
+        while (true) {
+            const auto line = get_output(limit);
+
+            if (line) {
+                if (func(*line)) {
+                    return;
+                }
+            } else if (!stopped) {
+                stopped = true;
+                stop();
+                limit = EngineClock::now() + grace_period;
+            } else {
+                kill();
+                throw EngineTimeout(*this, "Engine failed to respond in time");
+            }
         }
-        return line;
+    }
+
+    [[nodiscard]] static auto response_deadline() -> EngineClock::time_point {
+        return EngineClock::now() + response_timeout;
     }
 
    private:
+    // Pipes are close-on-exec, so other engines started later can't keep them open and hide this one exiting
+    // The engine's own ends of them are still passed on as its stdin and stdout
+    [[nodiscard]] static auto make_pipe() -> boost::process::pipe {
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC) == -1) {
+            throw std::runtime_error("Failed to create engine pipe");
+        }
+        return boost::process::pipe(fds[0], fds[1]);
+    }
+
+    [[nodiscard]] auto spawn(const std::string &path,
+                             const std::string &arguments,
+                             const std::function<void(const int fd)> &err) -> boost::process::child {
+        const auto command = path + (arguments.empty() ? "" : (" " + arguments));
+        const auto dir = std::filesystem::path(path).parent_path().string();
+
+        if (!err) {
+            return boost::process::child(command,
+                                         boost::process::start_dir(dir),
+                                         boost::process::std_out > m_out,
+                                         boost::process::std_in < m_in);
+        }
+
+        auto err_pipe = make_pipe();
+        auto child = boost::process::child(command,
+                                           boost::process::start_dir(dir),
+                                           boost::process::std_out > m_out,
+                                           boost::process::std_in < m_in,
+                                           boost::process::std_err > err_pipe);
+
+        const auto fd = err_pipe.native_source();
+        err_pipe.assign_source(-1);
+        err(fd);
+
+        return child;
+    }
+
+    // Closing the input flushes anything still unsent, which fails if the engine has gone
+    // The pipe is closed directly in that case, so the stream doesn't try flushing it all again when destroyed
+    auto close_streams() noexcept -> void {
+        try {
+            m_in.close();
+        } catch (...) {
+            m_in.pipe().close();
+        }
+        m_out.close();
+    }
+
+    [[nodiscard]] auto wait_readable(const EngineClock::time_point deadline) -> bool {
+        while (true) {
+            auto timeout = -1;
+            if (deadline != EngineClock::time_point::max()) {
+                const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - EngineClock::now());
+                timeout = static_cast<int>(std::clamp(remaining.count(), 0L, 1'000'000L));
+            }
+
+            epoll_event event;
+            const auto num_ready = epoll_wait(m_epoll, &event, 1, timeout);
+
+            if (num_ready > 0) {
+                return true;
+            } else if (num_ready == 0 && EngineClock::now() >= deadline) {
+                return false;
+            } else if (num_ready < 0 && errno != EINTR) {
+                throw std::runtime_error("Failed waiting for engine output");
+            }
+        }
+    }
+
     boost::process::opstream m_in;
     boost::process::ipstream m_out;
     boost::process::child m_child;
+    int m_epoll = -1;
+    LineBuffer m_buffer;
 };
 
 #endif
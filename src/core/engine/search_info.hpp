@@ -0,0 +1,123 @@
+#ifndef ENGINE_SEARCH_INFO_HPP
+#define ENGINE_SEARCH_INFO_HPP
+
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utils.hpp>
+
+// What an engine reported about its search in its last info line before moving
+struct SearchInfo {
+    enum class ScoreType : int
+    {
+        None = 0,
+        Cp,
+        Mate,
+    };
+
+    int depth = 0;
+    int seldepth = 0;
+    int time = 0;
+    std::uint64_t nodes = 0;
+    std::uint64_t nps = 0;
+    ScoreType score_type = ScoreType::None;
+    int score = 0;
+    std::string pv;
+};
+
+// Parse a UAI/UCI info line, ignoring "info string" and lines without a depth or score such as currmove updates
+// The pv is the only part that allocates, so it can be left out when all that matters is whether the line is useful
+[[nodiscard]] inline auto parse_info(const std::string_view line, const bool with_pv = true)
+    -> std::optional<SearchInfo> {
+    const auto parts = utils::tokenize<128>(line);
+
+    if (parts.empty() || parts[0] != "info" || (parts.size() > 1 && parts[1] == "string")) {
+        return {};
+    }
+
+    const auto parse_number = [](const std::string_view str, auto &value) {
+        std::from_chars(str.data(), str.data() + str.size(), value);
+    };
+
+    SearchInfo info;
+    auto useful = false;
+
+    for (std::size_t i = 1; i + 1 < parts.size(); ++i) {
+        if (parts[i] == "depth") {
+            parse_number(parts[++i], info.depth);
+            useful = true;
+        } else if (parts[i] == "seldepth") {
+            parse_number(parts[++i], info.seldepth);
+        } else if (parts[i] == "time") {
+            parse_number(parts[++i], info.time);
+        } else if (parts[i] == "nodes") {
+            parse_number(parts[++i], info.nodes);
+        } else if (parts[i] == "nps") {
+            parse_number(parts[++i], info.nps);
+        } else if (parts[i] == "score" && i + 2 < parts.size()) {
+            if (parts[i + 1] == "cp") {
+                info.score_type = SearchInfo::ScoreType::Cp;
+            } else if (parts[i + 1] == "mate") {
+                info.score_type = SearchInfo::ScoreType::Mate;
+            }
+            parse_number(parts[i + 2], info.score);
+            useful |= info.score_type != SearchInfo::ScoreType::None;
+            i += 2;
+        } else if (parts[i] == "pv") {
+            // The pv is always last
+            if (!with_pv) {
+                break;
+            }
+            for (++i; i < parts.size(); ++i) {
+                if (!info.pv.empty()) {
+                    info.pv += " ";
+                }
+                info.pv += parts[i];
+            }
+        }
+    }
+
+    if (!useful) {
+        return {};
+    }
+
+    return info;
+}
+
+// The last useful info line of a search, kept as the engine sent it and only parsed once the search is over
+// The storage is reused from one search to the next, so info lines coming in during a search don't allocate
+class InfoLine {
+   public:
+    static constexpr std::size_t reserved = 1024;
+
+    InfoLine() {
+        m_line.reserve(reserved);
+    }
+
+    // Returns true if the line was a useful info line, which is then kept in place of the last one
+    [[nodiscard]] auto keep(const std::string_view line) -> bool {
+        if (!parse_info(line, false)) {
+            return false;
+        }
+        m_line.assign(line);
+        return true;
+    }
+
+    auto clear() noexcept -> void {
+        m_line.clear();
+    }
+
+    [[nodiscard]] auto parse() const -> std::optional<SearchInfo> {
+        if (m_line.empty()) {
+            return {};
+        }
+        return parse_info(m_line);
+    }
+
+   private:
+    std::string m_line;
+};
+
+#endif
@@ -9,6 +9,7 @@ enum class EngineProtocol : int
     UAI,
     FSF,
     KataGo,
+    Plugin,
     Unknown,
 };
 
@@ -63,6 +64,14 @@ struct SearchSettings {
     int nodes = 0;
 };
 
+// When to wait for the engine to answer isready
+enum class SyncPolicy : int
+{
+    EveryMove = 0,
+    NewGame,
+    Never,
+};
+
 struct EngineSettings {
     int id;
     EngineProtocol proto = EngineProtocol::Unknown;
@@ -72,6 +81,9 @@ struct EngineSettings {
     std::string arguments;
     SearchSettings tc;
     std::vector<std::pair<std::string, std::string>> options;
+    bool send_moves = false;
+    bool ponder = false;
+    SyncPolicy sync = SyncPolicy::EveryMove;
 };
 
 #endif
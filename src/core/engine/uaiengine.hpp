@@ -1,10 +1,15 @@
 #ifndef UAI_ENGINE_PROCESS_HPP
 #define UAI_ENGINE_PROCESS_HPP
 
+#include <cstdint>
+#include <libataxx/move.hpp>
 #include <libataxx/position.hpp>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <utils.hpp>
+#include <vector>
 #include "process.hpp"
 
 class UAIEngine : public ProcessEngine {
@@ -12,29 +17,54 @@ class UAIEngine : public ProcessEngine {
     [[nodiscard]] UAIEngine(const std::string &path,
                             const std::string &arguments,
                             std::function<void(const std::string &msg)> send = {},
-                            std::function<void(const std::string &msg)> recv = {})
-        : ProcessEngine(path, arguments, send, recv) {
+                            std::function<void(const std::string &msg)> recv = {},
+                            std::function<void(const int fd)> err = {})
+        : ProcessEngine(path, arguments, send, recv, err) {
     }
 
     ~UAIEngine() {
         if (is_running()) {
-            send("stop");
-            send("quit");
+            try {
+                send("stop");
+                send("quit");
+            } catch (...) {
+            }
         }
     }
 
     virtual auto init() -> void override {
         send("uai");
-        wait_for("uaiok");
+        wait_for("uaiok", response_deadline());
+    }
+
+    virtual auto send_init(const std::vector<std::pair<std::string, std::string>> &options) -> void override {
+        send("uai");
+        for (const auto &[name, value] : options) {
+            set_option(name, value);
+        }
+        send("isready");
+    }
+
+    virtual auto wait_init() -> void override {
+        wait_for("uaiok", response_deadline());
+        wait_for("readyok", response_deadline());
     }
 
     virtual void isready() override {
         send("isready");
-        wait_for("readyok");
+        wait_for(
+            [this](const std::string_view msg) {
+                // Lines before the readyok might include the end of a stopped ponder search
+                auto movestr = std::string();
+                return !parse_output(msg, movestr) && msg == "readyok";
+            },
+            response_deadline());
     }
 
     virtual void newgame() override {
         send("uainewgame");
+        m_position.clear();
+        m_ponderhit = false;
     }
 
     virtual void quit() override {
@@ -46,74 +76,160 @@ class UAIEngine : public ProcessEngine {
     }
 
     virtual auto position(const libataxx::Position &pos) -> void override {
-        send("position fen " + pos.get_fen());
+        m_position.clear();
+        send("position fen " + pos.get_fen(), false);
+    }
+
+    virtual auto position_moves(const libataxx::Position &startpos, const std::vector<libataxx::Move> &moves)
+        -> void override {
+        // Later in the same game we only need to add the new moves to the last command
+        if (m_position.empty() || startpos.get_hash() != m_position_hash || moves.size() < m_position_moves) {
+            m_position = "position fen " + startpos.get_fen();
+            m_position_hash = startpos.get_hash();
+            m_position_moves = 0;
+        }
+
+        for (; m_position_moves < moves.size(); ++m_position_moves) {
+            m_position += m_position_moves == 0 ? " moves " : " ";
+            m_position += static_cast<std::string>(moves[m_position_moves]);
+        }
+
+        send(m_position, false);
     }
 
     virtual auto set_option(const std::string &name, const std::string &value) -> void override {
         send("setoption name " + name + " value " + value);
     }
 
-    [[nodiscard]] virtual auto go(const SearchSettings &settings) -> std::string override {
+    [[nodiscard]] virtual auto go(const SearchSettings &settings, const EngineClock::time_point deadline)
+        -> std::string override {
+        go_async(settings, deadline);
+
+        auto movestr = std::string("0000");
+
+        wait_for(
+            [this, &movestr](const std::string_view msg) {
+                return parse_output(msg, movestr);
+            },
+            deadline);
+
+        return movestr;
+    }
+
+    virtual auto go_async(const SearchSettings &settings, const EngineClock::time_point) -> void override {
+        // After a ponderhit the search is already running
+        if (std::exchange(m_ponderhit, false)) {
+            return;
+        }
+
+        m_search_info.reset();
+        m_info_line.clear();
+        m_ponder_move.reset();
+        send("go" + go_params(settings));
+    }
+
+    virtual auto go_ponder(const SearchSettings &settings) -> void override {
+        m_search_info.reset();
+        m_info_line.clear();
+        m_ponder_move.reset();
+        send("go ponder" + go_params(settings));
+    }
+
+    virtual auto ponderhit() -> void override {
+        send("ponderhit");
+        m_ponderhit = true;
+    }
+
+    // The bestmove the engine answers with is skipped whenever it turns up, rather than waited for here
+    virtual auto stop_ponder() -> void override {
+        send("stop");
+        m_stale_searches++;
+
+        // The last position we sent was the one we pondered on, rather than part of the game
+        m_position.clear();
+    }
+
+    [[nodiscard]] virtual auto poll_go() -> std::optional<std::string> override {
+        auto movestr = std::string("0000");
+
+        while (const auto line = get_output(EngineClock::now())) {
+            if (parse_output(*line, movestr)) {
+                return movestr;
+            }
+        }
+
+        return {};
+    }
+
+   private:
+    [[nodiscard]] static auto go_params(const SearchSettings &settings) -> std::string {
         switch (settings.type) {
             case SearchSettings::Type::Time: {
                 auto str = std::string();
-                str += "go";
                 str += " btime " + std::to_string(settings.btime);
                 str += " wtime " + std::to_string(settings.wtime);
                 str += " binc " + std::to_string(settings.binc);
                 str += " winc " + std::to_string(settings.winc);
-                send(str);
-                break;
+                return str;
             }
             case SearchSettings::Type::Movetime:
-                send("go movetime " + std::to_string(settings.movetime));
-                break;
+                return " movetime " + std::to_string(settings.movetime);
             case SearchSettings::Type::Depth:
-                send("go depth " + std::to_string(settings.ply));
-                break;
+                return " depth " + std::to_string(settings.ply);
             case SearchSettings::Type::Nodes:
-                send("go nodes " + std::to_string(settings.nodes));
-                break;
+                return " nodes " + std::to_string(settings.nodes);
             default:
-                return {};
+                return "";
         }
+    }
 
-        auto movestr = std::string("0000");
+    // Returns true once the search is over, keeping hold of the last useful info line before then
+    [[nodiscard]] auto parse_output(const std::string_view msg, std::string &movestr) -> bool {
+        if (m_info_line.keep(msg)) {
+            return false;
+        }
 
-        wait_for([&movestr](const std::string_view msg) {
-            const auto parts = utils::split(msg);
-            auto got_bestmove = false;
+        const auto parts = utils::tokenize(msg);
+        std::string_view bestmove;
+        std::string_view ponder;
 
-            for (std::size_t i = 0; i < parts.size(); i += 2) {
-                if (parts[i] == "bestmove") {
-                    movestr = parts[i + 1];
-                    got_bestmove = true;
-                }
+        for (std::size_t i = 0; i + 1 < parts.size(); i += 2) {
+            if (parts[i] == "bestmove") {
+                bestmove = parts[i + 1];
+            } else if (parts[i] == "ponder") {
+                ponder = parts[i + 1];
             }
+        }
 
-            return got_bestmove;
-        });
-
-        return movestr;
-    }
+        if (bestmove.empty()) {
+            return false;
+        }
 
-   private:
-    auto wait_for(const std::string &msg) -> void {
-        while (is_running()) {
-            const auto line = get_output();
-            if (line == msg) {
-                break;
-            }
+        // The end of a ponder search we stopped, rather than the search we're waiting on
+        if (m_stale_searches > 0) {
+            m_stale_searches--;
+            m_info_line.clear();
+            return false;
         }
-    }
 
-    auto wait_for(const std::function<bool(const std::string_view msg)> func) -> void {
-        auto exit = false;
-        while (is_running() && !exit) {
-            const auto line = get_output();
-            exit = func(line);
+        movestr = bestmove;
+        if (!ponder.empty()) {
+            m_ponder_move = std::string(ponder);
         }
+        m_search_info = m_info_line.parse();
+        m_info_line.clear();
+
+        return true;
     }
+
+    InfoLine m_info_line;
+    // The last position command sent with position_moves()
+    std::string m_position;
+    std::uint64_t m_position_hash = 0;
+    std::size_t m_position_moves = 0;
+    bool m_ponderhit = false;
+    // Stopped ponder searches whose bestmove hasn't turned up yet
+    int m_stale_searches = 0;
 };
 
 #endif
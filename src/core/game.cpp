@@ -0,0 +1,360 @@
+#include "game.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include "ataxx/adjudicate.hpp"
+#include "ataxx/parse_move.hpp"
+#include "rng.hpp"
+
+[[nodiscard]] constexpr auto make_win_for(const libataxx::Side s) noexcept {
+    return s == libataxx::Side::Black ? libataxx::Result::BlackWin : libataxx::Result::WhiteWin;
+}
+
+static_assert(make_win_for(libataxx::Side::Black) == libataxx::Result::BlackWin);
+static_assert(make_win_for(libataxx::Side::White) == libataxx::Result::WhiteWin);
+
+// How long the engine to move can take before it loses on time, if there's a limit
+[[nodiscard]] auto get_time_limit(const SearchSettings &tc, const libataxx::Side side, const int timeout_buffer)
+    -> std::optional<int> {
+    switch (tc.type) {
+        case SearchSettings::Type::Movetime:
+            return tc.movetime + timeout_buffer;
+        case SearchSettings::Type::Time:
+            return (side == libataxx::Side::Black ? tc.btime : tc.wtime) + timeout_buffer;
+        default:
+            return {};
+    }
+}
+
+// The point after which the engine to move has lost on time and can be stopped
+[[nodiscard]] auto get_deadline(const SearchSettings &tc,
+                                const libataxx::Side side,
+                                const int timeout_buffer,
+                                const EngineClock::time_point t0) -> EngineClock::time_point {
+    const auto limit = get_time_limit(tc, side, timeout_buffer);
+    if (!limit) {
+        return EngineClock::time_point::max();
+    }
+    return t0 + std::chrono::milliseconds(*limit + 1);
+}
+
+Game::Game(const AdjudicationSettings &adjudication,
+           const GameSettings &game,
+           std::shared_ptr<Engine> engine1,
+           std::shared_ptr<Engine> engine2,
+           std::function<bool(GameThingy info, SearchSettings tc1, SearchSettings tc2)> on_new_move)
+    : m_adjudication(adjudication),
+      m_game(game),
+      m_engine1(engine1),
+      m_engine2(engine2),
+      m_on_new_move(on_new_move),
+      m_tc1(game.engine1.tc),
+      m_tc2(game.engine2.tc) {
+    assert(!game.fen.empty());
+    assert(game.engine1.id != game.engine2.id);
+
+    // Get engine & position settings
+    m_info.endpos = libataxx::Position{game.fen};
+    m_info.startpos = m_info.endpos;
+    m_info.seed = game.seed;
+}
+
+auto Game::start() -> void {
+    m_engine1->seed(derive_seed(m_game.seed, 1));
+    m_engine2->seed(derive_seed(m_game.seed, 2));
+    m_engine1->newgame();
+    m_engine2->newgame();
+
+    if (m_game.engine1.sync != SyncPolicy::Never) {
+        sync(*m_engine1, m_info.sync1);
+    }
+
+    if (m_game.engine2.sync != SyncPolicy::Never) {
+        sync(*m_engine2, m_info.sync2);
+    }
+}
+
+auto Game::sync(Engine &engine, SyncThingy &stats) -> void {
+    const auto t0 = EngineClock::now();
+    engine.isready();
+    const auto t1 = EngineClock::now();
+
+    stats.count++;
+    stats.time += std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+}
+
+[[nodiscard]] auto Game::begin_move() -> bool {
+    if (m_over || m_info.endpos.is_gameover()) {
+        return false;
+    }
+
+    // Try to adjudicate based on material imbalance
+    if (m_adjudication.material && can_adjudicate_material(m_info.endpos, *m_adjudication.material)) {
+        m_info.result = make_win_for(m_info.endpos.get_turn());
+        m_info.reason = ResultReason::MaterialImbalance;
+        return false;
+    }
+
+    // Try to adjudicate based on "easy fill"
+    // This is when one side has to pass and the other can fill the rest of the board trivially to win
+    if (m_adjudication.easyfill && can_adjudicate_easyfill(m_info.endpos)) {
+        m_info.result = make_win_for(!m_info.endpos.get_turn());
+        m_info.reason = ResultReason::EasyFill;
+        return false;
+    }
+
+    // Try to adjudicate based on game length
+    if (m_adjudication.gamelength && can_adjudicate_gamelength(m_info.endpos, *m_adjudication.gamelength)) {
+        m_info.result = libataxx::Result::Draw;
+        m_info.reason = ResultReason::Gamelength;
+        return false;
+    }
+
+    const auto is_black = m_info.endpos.get_turn() == libataxx::Side::Black;
+    auto &engine = engine_to_move();
+    const auto &engine_settings = is_black ? m_game.engine1 : m_game.engine2;
+    auto &sync_stats = is_black ? m_info.sync1 : m_info.sync2;
+    auto &ponder = is_black ? m_ponder1 : m_ponder2;
+
+    if (ponder) {
+        const auto expected = *ponder;
+        ponder.reset();
+
+        // The engine has been searching this position already, so all it needs is to start its clock
+        if (m_moves.back() == expected) {
+            engine.ponderhit();
+            m_t0 = EngineClock::now();
+            m_deadline = get_deadline(tc_to_move(), m_info.endpos.get_turn(), m_adjudication.timeout_buffer, m_t0);
+            return true;
+        }
+
+        engine.stop_ponder();
+    }
+
+    if (engine_settings.send_moves) {
+        engine.position_moves(m_info.startpos, m_moves);
+    } else {
+        engine.position(m_info.endpos);
+    }
+
+    if (engine_settings.sync == SyncPolicy::EveryMove) {
+        sync(engine, sync_stats);
+    } else {
+        sync_stats.skipped++;
+    }
+
+    // Start move timer
+    m_t0 = EngineClock::now();
+    m_deadline = get_deadline(tc_to_move(), m_info.endpos.get_turn(), m_adjudication.timeout_buffer, m_t0);
+
+    return true;
+}
+
+auto Game::end_move(const std::string &movestr) -> void {
+    // Stop move timer
+    const auto t1 = EngineClock::now();
+
+    // Get move time
+    const auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - m_t0);
+
+    const auto &tc_us = tc_to_move();
+    const auto limit = get_time_limit(tc_us, m_info.endpos.get_turn(), m_adjudication.timeout_buffer);
+    libataxx::Move move;
+
+    try {
+        // Parse move string
+        move = parse_move(movestr);
+
+        // Illegal move
+        if (!m_info.endpos.is_legal_move(move)) {
+            throw std::logic_error("Illegal move");
+        }
+    } catch (...) {
+        m_info.result = make_win_for(!m_info.endpos.get_turn());
+        m_info.reason = ResultReason::IllegalMove;
+        std::cout << "Illegal move \"" << movestr << "\" played by "
+                  << (m_info.endpos.get_turn() == libataxx::Side::Black ? m_game.engine1.name : m_game.engine2.name)
+                  << "\n\n";
+    }
+
+    // Out of time?
+    if (limit && diff.count() > *limit) {
+        m_info.result = make_win_for(!m_info.endpos.get_turn());
+        m_info.reason = ResultReason::OutOfTime;
+        m_over = true;
+        return;
+    }
+
+    // Update clocks, with any time taken out of the timeout buffer leaving the clock at zero
+    if (tc_us.type == SearchSettings::Type::Time) {
+        const auto used = static_cast<int>(diff.count());
+        if (m_info.endpos.get_turn() == libataxx::Side::Black) {
+            m_tc1.btime = m_tc2.btime = std::max(0, m_tc1.btime - used);
+        } else {
+            m_tc1.wtime = m_tc2.wtime = std::max(0, m_tc1.wtime - used);
+        }
+    }
+
+    if (m_info.reason == ResultReason::IllegalMove) {
+        m_over = true;
+        return;
+    }
+
+    // Add move to .pgn
+    m_info.history.emplace_back(move, diff.count(), engine_to_move().search_info());
+    m_moves.push_back(move);
+
+    // Increments
+    if (tc_us.type == SearchSettings::Type::Time) {
+        if (m_info.endpos.get_turn() == libataxx::Side::Black) {
+            m_tc1.btime += tc_us.binc;
+            m_tc2.btime += tc_us.binc;
+        } else {
+            m_tc1.wtime += tc_us.winc;
+            m_tc2.wtime += tc_us.winc;
+        }
+    }
+
+    m_info.endpos.makemove(move);
+
+    start_ponder();
+
+    const bool continue_game = m_on_new_move(m_info, m_tc1, m_tc2);
+    if (!continue_game) {
+        m_over = true;
+    }
+}
+
+auto Game::start_ponder() -> void {
+    const auto is_black = m_info.endpos.get_turn() == libataxx::Side::White;
+    auto &engine = is_black ? *m_engine1 : *m_engine2;
+    const auto &engine_settings = is_black ? m_game.engine1 : m_game.engine2;
+    const auto &reply = engine.ponder_move();
+
+    if (!engine_settings.ponder || !reply || m_info.endpos.is_gameover()) {
+        return;
+    }
+
+    libataxx::Move move;
+    try {
+        move = parse_move(*reply);
+    } catch (...) {
+        return;
+    }
+
+    if (!m_info.endpos.is_legal_move(move)) {
+        return;
+    }
+
+    // Problems with the engine are left to show up on its own turn, where they cost it the game
+    try {
+        if (engine_settings.send_moves) {
+            auto moves = m_moves;
+            moves.push_back(move);
+            engine.position_moves(m_info.startpos, moves);
+        } else {
+            auto pos = m_info.endpos;
+            pos.makemove(move);
+            engine.position(pos);
+        }
+
+        // The engine's own clock isn't running while it ponders, so it gets the times as they are now
+        engine.go_ponder(is_black ? m_tc1 : m_tc2);
+    } catch (...) {
+        return;
+    }
+
+    (is_black ? m_ponder1 : m_ponder2) = move;
+}
+
+[[nodiscard]] auto Game::restart_crashed(const EngineRestart &restart) -> bool {
+    const auto crashed1 = !m_engine1->is_running();
+    const auto crashed2 = !m_engine2->is_running();
+
+    // Engines that are still running are left to lose the game, whatever went wrong with them
+    if (!crashed1 && !crashed2) {
+        return false;
+    }
+
+    if ((crashed1 && m_info.restarts1 >= max_restarts) || (crashed2 && m_info.restarts2 >= max_restarts)) {
+        return false;
+    }
+
+    try {
+        if (crashed1) {
+            m_info.restarts1++;
+            m_ponder1.reset();
+            m_engine1 = restart(m_game.engine1);
+            m_engine1->seed(derive_seed(m_game.seed, 1));
+            m_engine1->newgame();
+        }
+
+        if (crashed2) {
+            m_info.restarts2++;
+            m_ponder2.reset();
+            m_engine2 = restart(m_game.engine2);
+            m_engine2->seed(derive_seed(m_game.seed, 2));
+            m_engine2->newgame();
+        }
+    } catch (...) {
+        return false;
+    }
+
+    return true;
+}
+
+auto Game::abort(const ResultReason reason) -> void {
+    m_info.reason = reason;
+    m_info.result = make_win_for(!m_info.endpos.get_turn());
+    m_over = true;
+}
+
+auto Game::abort(const ResultReason reason, const Engine &engine) -> void {
+    if (&engine == m_engine1.get()) {
+        m_info.reason = reason;
+        m_info.result = libataxx::Result::WhiteWin;
+        m_over = true;
+    } else if (&engine == m_engine2.get()) {
+        m_info.reason = reason;
+        m_info.result = libataxx::Result::BlackWin;
+        m_over = true;
+    } else {
+        abort(reason);
+    }
+}
+
+[[nodiscard]] auto Game::finish() -> GameThingy {
+    // Engines can't be left pondering once the game is over
+    if (m_ponder1) {
+        m_ponder1.reset();
+        try {
+            m_engine1->stop_ponder();
+        } catch (...) {
+        }
+    }
+
+    if (m_ponder2) {
+        m_ponder2.reset();
+        try {
+            m_engine2->stop_ponder();
+        } catch (...) {
+        }
+    }
+
+    // Game finished normally
+    if (m_info.result == libataxx::Result::None) {
+        m_info.result = m_info.endpos.get_result();
+    }
+
+    return m_info;
+}
+
+[[nodiscard]] auto Game::engine_to_move() -> Engine & {
+    return m_info.endpos.get_turn() == libataxx::Side::Black ? *m_engine1 : *m_engine2;
+}
+
+[[nodiscard]] auto Game::tc_to_move() const -> const SearchSettings & {
+    return m_info.endpos.get_turn() == libataxx::Side::Black ? m_tc1 : m_tc2;
+}
@@ -0,0 +1,77 @@
+#ifndef GAME_HPP
+#define GAME_HPP
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "engine/engine.hpp"
+#include "play.hpp"
+
+// A single game broken down into moves, so it can be driven either by blocking on the engines or by an event loop
+class Game {
+   public:
+    // How many times each engine can be restarted during a game before its crashes cost it the game
+    static constexpr int max_restarts = 3;
+
+    [[nodiscard]] Game(const AdjudicationSettings &adjudication,
+                       const GameSettings &game,
+                       std::shared_ptr<Engine> engine1,
+                       std::shared_ptr<Engine> engine2,
+                       std::function<bool(GameThingy info, SearchSettings tc1, SearchSettings tc2)> on_new_move);
+
+    // Tell the engines a new game is starting, and wait for them to be ready unless their sync policy is never
+    auto start() -> void;
+
+    // Returns false if the game is over, otherwise the position is sent to the engine to move and its clock started
+    // The position is only flushed out to the engine along with the go command, unless it syncs every move
+    [[nodiscard]] auto begin_move() -> bool;
+
+    // Stop the clock and play the move the engine returned
+    auto end_move(const std::string &movestr) -> void;
+
+    // Replace any engines that are no longer running, so the game can continue from the current position
+    // Returns false if there were none, or they've already been restarted too often
+    [[nodiscard]] auto restart_crashed(const EngineRestart &restart) -> bool;
+
+    // End the game early as a loss for the side to move
+    auto abort(const ResultReason reason) -> void;
+
+    // End the game early as a loss for the engine, such as one that timed out while it wasn't its turn
+    auto abort(const ResultReason reason, const Engine &engine) -> void;
+
+    [[nodiscard]] auto finish() -> GameThingy;
+
+    [[nodiscard]] auto engine_to_move() -> Engine &;
+
+    [[nodiscard]] auto tc_to_move() const -> const SearchSettings &;
+
+    [[nodiscard]] auto deadline() const noexcept -> EngineClock::time_point {
+        return m_deadline;
+    }
+
+   private:
+    auto sync(Engine &engine, SyncThingy &stats) -> void;
+
+    // Leave the engine that just moved thinking about the reply it expects, on its opponent's time
+    auto start_ponder() -> void;
+
+    const AdjudicationSettings &m_adjudication;
+    GameSettings m_game;
+    std::shared_ptr<Engine> m_engine1;
+    std::shared_ptr<Engine> m_engine2;
+    std::function<bool(GameThingy info, SearchSettings tc1, SearchSettings tc2)> m_on_new_move;
+    GameThingy m_info;
+    std::vector<libataxx::Move> m_moves;
+    // The reply each engine is pondering on
+    std::optional<libataxx::Move> m_ponder1;
+    std::optional<libataxx::Move> m_ponder2;
+    SearchSettings m_tc1;
+    SearchSettings m_tc2;
+    EngineClock::time_point m_t0;
+    EngineClock::time_point m_deadline;
+    bool m_over = false;
+};
+
+#endif
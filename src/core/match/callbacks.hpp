@@ -1,17 +1,28 @@
 #ifndef CUTEATAXX_CORE_CALLBACKS_HPP
 #define CUTEATAXX_CORE_CALLBACKS_HPP
 
+#include <chrono>
 #include <functional>
 #include <string>
+#include "../engine/search_info.hpp"
 #include "results.hpp"
 
 struct Callbacks {
     std::function<void(const std::string &)> on_engine_start;
+    std::function<void(const std::string &, const std::chrono::milliseconds)> on_engine_ready;
     std::function<void(const int, const std::string &, const std::string &)> on_game_started;
     std::function<void(const int, const std::string &, const std::string &)> on_game_finished;
     std::function<void(const Results &)> on_results_update;
-    std::function<void(const std::string &)> on_info_send;
-    std::function<void(const std::string &)> on_info_recv;
+    // Called with the engine's name and the message, when debugging
+    std::function<void(const std::string &, const std::string &)> on_info_send;
+    std::function<void(const std::string &, const std::string &)> on_info_recv;
+    // Optional, called with what an engine reported about the search for each move it plays
+    std::function<void(const std::string &, const SearchInfo &)> on_search_info;
+    // Optional, given the read end of a pipe carrying a new engine process's stderr, which it then owns
+    // Engines share our stderr if not set
+    std::function<void(const std::string &, const int)> on_engine_stderr;
+    // Optional, called with both engines' names and the LLR when the SPRT stops a pairing early
+    std::function<void(const std::string &, const std::string &, const float)> on_pairing_decided;
 };
 
 #endif
@@ -0,0 +1,189 @@
+#include "checkpoint.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include "settings.hpp"
+
+namespace {
+
+constexpr auto header = "cuteataxx-checkpoint 1";
+
+}  // namespace
+
+// One line per item, with engine names last as they can contain spaces
+auto save_checkpoint(const std::string &path, const Checkpoint &checkpoint) -> void {
+    const auto tmp_path = path + ".tmp";
+
+    {
+        std::ofstream file(tmp_path, std::ofstream::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not write checkpoint " + tmp_path);
+        }
+
+        const auto &results = checkpoint.results;
+
+        file << header << "\n";
+        file << "settings " << checkpoint.settings_hash << "\n";
+        file << "seed " << checkpoint.seed << "\n";
+        file << "games " << results.games_started << " " << results.games_played << " " << results.black_wins << " "
+             << results.white_wins << " " << results.draws << "\n";
+
+        for (const auto &[name, score] : results.scores) {
+            file << "score " << score.wins << " " << score.draws << " " << score.losses << " " << score.crashes << " "
+                 << score.played << " " << score.syncs << " " << score.syncs_skipped << " "
+                 << score.sync_time.count() << " " << name << "\n";
+        }
+
+        for (const auto &[engines, pairing] : results.pairings) {
+            file << "pairing " << engines.first << " " << engines.second << " " << pairing.wins << " "
+                 << pairing.losses << " " << pairing.draws << " " << pairing.decided;
+            for (const auto count : pairing.pairs) {
+                file << " " << count;
+            }
+            file << "\n";
+
+            for (const auto &[opening, games] : pairing.unpaired) {
+                for (const auto &[first_black, points] : games) {
+                    file << "unpaired " << engines.first << " " << engines.second << " " << opening << " "
+                         << first_black << " " << points << "\n";
+                }
+            }
+        }
+
+        for (const auto &[first, last] : results.completed) {
+            file << "completed " << first << " " << last << "\n";
+        }
+
+        if (checkpoint.pgn_size) {
+            file << "pgn " << *checkpoint.pgn_size << "\n";
+        }
+
+        file.flush();
+        if (!file) {
+            throw std::runtime_error("Could not write checkpoint " + tmp_path);
+        }
+    }
+
+    std::filesystem::rename(tmp_path, path);
+}
+
+auto load_checkpoint(const std::string &path) -> Checkpoint {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open checkpoint " + path);
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != header) {
+        throw std::runtime_error("Not a checkpoint: " + path);
+    }
+
+    Checkpoint checkpoint;
+    auto &results = checkpoint.results;
+
+    while (std::getline(file, line)) {
+        std::istringstream ss(line);
+        std::string kind;
+        ss >> kind;
+
+        if (kind == "settings") {
+            ss >> checkpoint.settings_hash;
+        } else if (kind == "seed") {
+            ss >> checkpoint.seed;
+        } else if (kind == "games") {
+            ss >> results.games_started >> results.games_played >> results.black_wins >> results.white_wins >>
+                results.draws;
+        } else if (kind == "score") {
+            Score score;
+            std::int64_t sync_time = 0;
+            ss >> score.wins >> score.draws >> score.losses >> score.crashes >> score.played >> score.syncs >>
+                score.syncs_skipped >> sync_time;
+            score.sync_time = std::chrono::microseconds(sync_time);
+
+            std::string name;
+            ss.get();
+            std::getline(ss, name);
+            results.scores[name] = score;
+        } else if (kind == "pairing") {
+            std::size_t first = 0;
+            std::size_t second = 0;
+            ss >> first >> second;
+            auto &pairing = results.pairings[{first, second}];
+            ss >> pairing.wins >> pairing.losses >> pairing.draws >> pairing.decided;
+            for (auto &count : pairing.pairs) {
+                ss >> count;
+            }
+        } else if (kind == "unpaired") {
+            std::size_t first = 0;
+            std::size_t second = 0;
+            std::size_t opening = 0;
+            bool first_black = false;
+            int points = 0;
+            ss >> first >> second >> opening >> first_black >> points;
+            results.pairings[{first, second}].unpaired[opening].emplace_back(first_black, points);
+        } else if (kind == "completed") {
+            std::size_t first = 0;
+            std::size_t last = 0;
+            ss >> first >> last;
+            results.completed[first] = last;
+        } else if (kind == "pgn") {
+            std::uintmax_t size = 0;
+            ss >> size;
+            checkpoint.pgn_size = size;
+        } else {
+            throw std::runtime_error("Unrecognised line in checkpoint " + path + ": " + line);
+        }
+
+        if (ss.fail()) {
+            throw std::runtime_error("Bad line in checkpoint " + path + ": " + line);
+        }
+    }
+
+    return checkpoint;
+}
+
+auto make_checkpoint(const Settings &settings, const Results &results) -> Checkpoint {
+    auto checkpoint = Checkpoint{settings.hash, settings.seed, results, std::nullopt};
+
+    // Games are written to the PGN under the same lock as the results, so its size matches them
+    if (settings.pgn.enabled && !settings.pgn.path.empty()) {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(settings.pgn.path, ec);
+        checkpoint.pgn_size = ec ? 0 : size;
+    }
+
+    return checkpoint;
+}
+
+auto save_checkpoint(const Settings &settings, const Results &results) -> void {
+    if (settings.checkpoint.path.empty()) {
+        return;
+    }
+    save_checkpoint(settings.checkpoint.path, make_checkpoint(settings, results));
+}
+
+auto load_checkpoint(const Settings &settings) -> Checkpoint {
+    if (settings.checkpoint.path.empty()) {
+        throw std::invalid_argument("Can't resume without a checkpoint path");
+    }
+
+    const auto checkpoint = load_checkpoint(settings.checkpoint.path);
+    if (checkpoint.settings_hash != settings.hash) {
+        throw std::invalid_argument("Checkpoint " + settings.checkpoint.path + " was written with different settings");
+    }
+    return checkpoint;
+}
+
+auto restore_pgn(const Settings &settings, const Checkpoint &checkpoint) -> void {
+    if (!settings.pgn.enabled || settings.pgn.path.empty() || !checkpoint.pgn_size) {
+        return;
+    }
+
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(settings.pgn.path, ec);
+    if (!ec && size > *checkpoint.pgn_size) {
+        std::filesystem::resize_file(settings.pgn.path, *checkpoint.pgn_size);
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef MATCH_CHECKPOINT_HPP
+#define MATCH_CHECKPOINT_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include "results.hpp"
+
+class Settings;
+
+// What's needed to carry on with a tournament after a restart
+// Games in play when the checkpoint was written aren't in the results, so they're played again
+struct Checkpoint {
+    std::uint64_t settings_hash = 0;
+    // The seed the tournament was started with, which decides its openings and games
+    std::uint64_t seed = 0;
+    Results results;
+    // How much of the PGN the results cover, as games finished after the checkpoint are played again
+    std::optional<std::uintmax_t> pgn_size;
+};
+
+// Write the checkpoint to the path, replacing the previous one all at once so a crash can't leave half of it
+auto save_checkpoint(const std::string &path, const Checkpoint &checkpoint) -> void;
+
+// Throws if the file can't be read or isn't a checkpoint
+[[nodiscard]] auto load_checkpoint(const std::string &path) -> Checkpoint;
+
+// What the settings' checkpoint holds with the results as they are now, including how much of the PGN they cover
+[[nodiscard]] auto make_checkpoint(const Settings &settings, const Results &results) -> Checkpoint;
+
+// Write the settings' checkpoint, if they ask for them
+auto save_checkpoint(const Settings &settings, const Results &results) -> void;
+
+// Read the settings' checkpoint, throwing if it was written with different settings
+[[nodiscard]] auto load_checkpoint(const Settings &settings) -> Checkpoint;
+
+// Cut the PGN back to the games the checkpoint covers, so the games played again don't show up twice
+auto restore_pgn(const Settings &settings, const Checkpoint &checkpoint) -> void;
+
+#endif
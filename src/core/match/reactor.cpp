@@ -0,0 +1,296 @@
+#include "reactor.hpp"
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "../affinity.hpp"
+#include "../engine/engine.hpp"
+#include "../engine/pool.hpp"
+#include "../engine/process.hpp"
+#include "../game.hpp"
+#include "../play.hpp"
+#include "../play_builtin.hpp"
+#include "../rng.hpp"
+#include "results.hpp"
+#include "settings.hpp"
+#include "worker.hpp"
+
+namespace {
+
+struct Slot {
+    Schedule::Cursor cursor;
+    GameInfo info;
+    GameSettings game;
+    std::vector<int> cpus;
+    std::optional<Game> state;
+    std::shared_ptr<Engine> engine1;
+    std::shared_ptr<Engine> engine2;
+    EngineRestart restart;
+    // The engine whose move we're waiting on
+    Engine *waiting = nullptr;
+    EngineClock::time_point deadline = EngineClock::time_point::max();
+    bool stopped = false;
+};
+
+}  // namespace
+
+void reactor(const Settings &settings,
+             const std::vector<std::string> &openings,
+             Schedule &schedule,
+             EnginePool &engine_pool,
+             Results &results,
+             const Callbacks &callbacks,
+             const std::vector<std::vector<int>> &slot_cpus) {
+    const auto epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll == -1) {
+        throw std::runtime_error("Failed to create epoll instance");
+    }
+
+    std::vector<Slot> slots(slot_cpus.size());
+    std::vector<int> all_cpus;
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+        slots[i].cpus = slot_cpus[i];
+        all_cpus.insert(all_cpus.end(), slot_cpus[i].begin(), slot_cpus[i].end());
+    }
+
+    // Builtin engines play on this thread
+    pin_thread(all_cpus);
+
+    auto should_stop = false;
+
+    const auto unwatch = [epoll](Slot &slot) {
+        if (slot.waiting) {
+            epoll_ctl(epoll, EPOLL_CTL_DEL, slot.waiting->output_fd(), nullptr);
+            slot.waiting = nullptr;
+        }
+    };
+
+    const auto finish = [&](Slot &slot) {
+        const auto game_data = slot.state->finish();
+        slot.state.reset();
+
+        return_engines(engine_pool, slot.game, std::move(slot.engine1), std::move(slot.engine2));
+
+        callbacks.on_game_finished(0, slot.game.engine1.name, slot.game.engine2.name);
+
+        if (reschedule_game(settings, results, slot.info, slot.game, game_data)) {
+            return;
+        }
+
+        // Results & printing
+        should_stop |= record_game(settings, results, schedule, slot.info, slot.game, game_data, callbacks);
+    };
+
+    // Carry on from the current position if the engines that crashed can be replaced
+    const auto recover = [](Slot &slot) -> bool {
+        return slot.restart && slot.state->restart_crashed(slot.restart);
+    };
+
+    // Play moves until the game is over or we have to wait for an engine
+    const auto advance = [&](Slot &slot) {
+        while (true) {
+            try {
+                while (slot.state->begin_move()) {
+                    auto &engine = slot.state->engine_to_move();
+                    engine.go_async(slot.state->tc_to_move(), slot.state->deadline());
+
+                    // Builtin engines have their move ready immediately
+                    if (const auto movestr = engine.poll_go()) {
+                        slot.state->end_move(*movestr);
+                        continue;
+                    }
+
+                    epoll_event event{};
+                    event.events = EPOLLIN;
+                    event.data.ptr = &slot;
+                    if (epoll_ctl(epoll, EPOLL_CTL_ADD, engine.output_fd(), &event) == -1) {
+                        throw std::runtime_error("Failed to watch engine output");
+                    }
+
+                    slot.waiting = &engine;
+                    slot.deadline = slot.state->deadline();
+                    slot.stopped = false;
+                    return;
+                }
+                break;
+            } catch (const EngineTimeout &e) {
+                unwatch(slot);
+                slot.state->abort(ResultReason::OutOfTime, e.engine());
+                break;
+            } catch (...) {
+                unwatch(slot);
+                if (!recover(slot)) {
+                    slot.state->abort(ResultReason::EngineCrash);
+                    break;
+                }
+            }
+        }
+
+        finish(slot);
+    };
+
+    const auto start = [&](Slot &slot) -> bool {
+        const auto game_info = next_game(schedule, slot.cursor);
+        if (!game_info) {
+            return false;
+        }
+
+        slot.info = *game_info;
+        slot.game = GameSettings(openings[game_info->idx_opening],
+                                 settings.engines[game_info->idx_player1],
+                                 settings.engines[game_info->idx_player2],
+                                 derive_seed(settings.seed, game_info->id));
+
+        // Syncing every move would mean waiting on the engine in the middle of the event loop
+        for (auto *engine : {&slot.game.engine1, &slot.game.engine2}) {
+            if (engine->sync == SyncPolicy::EveryMove) {
+                engine->sync = SyncPolicy::NewGame;
+            }
+        }
+
+        callbacks.on_game_started(0, slot.game.engine1.name, slot.game.engine2.name);
+
+        // Games between builtins don't need any engines, and are over straight away
+        if (const auto game_data = play_builtin(settings.adjudication, slot.game)) {
+            callbacks.on_game_finished(0, slot.game.engine1.name, slot.game.engine2.name);
+            should_stop |= record_game(settings, results, schedule, slot.info, slot.game, *game_data, callbacks);
+            return true;
+        }
+
+        std::tie(slot.engine1, slot.engine2) = get_engines(engine_pool, slot.game, settings, callbacks, false);
+        slot.engine1->set_affinity(slot.cpus);
+        slot.engine2->set_affinity(slot.cpus);
+        slot.restart = make_restart(settings, callbacks, slot.game, slot.engine1, slot.engine2, slot.cpus);
+
+        slot.state.emplace(settings.adjudication,
+                           slot.game,
+                           slot.engine1,
+                           slot.engine2,
+                           [&slot, &callbacks](GameThingy info, SearchSettings, SearchSettings) {
+                               report_search_info(slot.game, info, callbacks);
+                               return true;
+                           });
+
+        try {
+            slot.state->start();
+        } catch (const EngineTimeout &e) {
+            slot.state->abort(ResultReason::OutOfTime, e.engine());
+            finish(slot);
+            return true;
+        } catch (...) {
+            if (!recover(slot)) {
+                slot.state->abort(ResultReason::EngineCrash);
+                finish(slot);
+                return true;
+            }
+        }
+
+        advance(slot);
+        return true;
+    };
+
+    const auto on_output = [&](Slot &slot) {
+        if (!slot.waiting) {
+            return;
+        }
+
+        std::optional<std::string> movestr;
+
+        try {
+            movestr = slot.waiting->poll_go();
+        } catch (...) {
+            unwatch(slot);
+            if (recover(slot)) {
+                advance(slot);
+            } else {
+                slot.state->abort(ResultReason::EngineCrash);
+                finish(slot);
+            }
+            return;
+        }
+
+        if (movestr) {
+            unwatch(slot);
+            slot.state->end_move(*movestr);
+            advance(slot);
+        }
+    };
+
+    // Past the deadline the engine is told to stop, then killed if it still hasn't moved after the grace period
+    const auto on_deadline = [&](Slot &slot) {
+        if (!slot.stopped) {
+            try {
+                slot.waiting->stop();
+            } catch (...) {
+            }
+            slot.stopped = true;
+            slot.deadline = EngineClock::now() + ProcessEngine::grace_period;
+        } else {
+            auto &engine = *slot.waiting;
+            unwatch(slot);
+            engine.kill();
+            slot.state->abort(ResultReason::OutOfTime);
+            finish(slot);
+        }
+    };
+
+    while (true) {
+        // Fill idle slots with new games
+        // Running out isn't final, as games voided by a crash can be rescheduled later on
+        for (auto &slot : slots) {
+            while (!slot.state && !should_stop) {
+                if (!start(slot)) {
+                    break;
+                }
+            }
+        }
+
+        // Every game in progress is waiting on an engine, so if there are none we're done
+        // Unless Swiss games are still to be paired from results coming in on other threads
+        const auto nearest = std::min_element(slots.begin(), slots.end(), [](const Slot &a, const Slot &b) {
+            return (a.waiting ? a.deadline : EngineClock::time_point::max()) <
+                   (b.waiting ? b.deadline : EngineClock::time_point::max());
+        });
+
+        if (nearest == slots.end() || !nearest->waiting) {
+            if (!should_stop && schedule.wait()) {
+                continue;
+            }
+            break;
+        }
+
+        // Wait for engine output, or until the nearest deadline
+        auto timeout = -1;
+        if (nearest->deadline != EngineClock::time_point::max()) {
+            const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(nearest->deadline - EngineClock::now());
+            timeout = static_cast<int>(std::clamp(remaining.count(), 0L, 1'000'000L));
+        }
+
+        epoll_event events[64];
+        const auto num_ready = epoll_wait(epoll, events, 64, timeout);
+        if (num_ready < 0 && errno != EINTR) {
+            close(epoll);
+            throw std::runtime_error("Failed waiting for engine output");
+        }
+
+        for (int i = 0; i < num_ready; ++i) {
+            on_output(*static_cast<Slot *>(events[i].data.ptr));
+        }
+
+        // Deal with engines that have run out of time
+        const auto now = EngineClock::now();
+        for (auto &slot : slots) {
+            if (slot.waiting && slot.deadline <= now) {
+                on_deadline(slot);
+            }
+        }
+    }
+
+    close(epoll);
+}
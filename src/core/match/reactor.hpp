@@ -0,0 +1,24 @@
+#ifndef MATCH_REACTOR_HPP
+#define MATCH_REACTOR_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "../tournament/schedule.hpp"
+#include "callbacks.hpp"
+
+class Settings;
+class Results;
+class EnginePool;
+
+// Play a game in each slot at once on a single thread, advancing each game whenever its engine has output ready
+// Each slot's engines are pinned to its CPUs, unless there are none
+void reactor(const Settings &settings,
+             const std::vector<std::string> &openings,
+             Schedule &schedule,
+             EnginePool &engine_pool,
+             Results &results,
+             const Callbacks &callbacks,
+             const std::vector<std::vector<int>> &slot_cpus);
+
+#endif
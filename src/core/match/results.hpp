@@ -1,9 +1,15 @@
 #ifndef MATCH_RESULTS_HPP
 #define MATCH_RESULTS_HPP
 
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <iomanip>
+#include <iterator>
 #include <map>
+#include <sprt.hpp>
 #include <string>
+#include <vector>
 
 struct Score {
     int wins = 0;
@@ -11,6 +17,24 @@ struct Score {
     int losses = 0;
     int crashes = 0;
     int played = 0;
+    // isready round trips waited on, and skipped by the engine's sync policy
+    int syncs = 0;
+    int syncs_skipped = 0;
+    std::chrono::microseconds sync_time{0};
+};
+
+// The games between two engines, from the point of view of the one listed first in the settings
+struct PairingScore {
+    int wins = 0;
+    int losses = 0;
+    int draws = 0;
+    // How many pairs of games on the same opening with colours swapped scored 0-4 half points
+    std::array<int, 5> pairs{};
+    // Games waiting on the other game of their pair, by opening index
+    // Each has whether the first engine was black, and its score out of 2
+    std::map<std::size_t, std::vector<std::pair<bool, int>>> unpaired;
+    // The SPRT or precision setting has stopped the pairing, and its remaining games are skipped
+    bool decided = false;
 };
 
 struct Results {
@@ -20,8 +44,86 @@ struct Results {
     int white_wins = 0;
     int draws = 0;
     std::map<std::string, Score> scores;
+    // Indexed by the engines' indices in the settings, lowest first
+    std::map<std::pair<std::size_t, std::size_t>, PairingScore> pairings;
+    // The ids of every game recorded, as ranges from first to one past the last
+    std::map<std::size_t, std::size_t> completed;
 };
 
+// Add a game id to the completed ranges, merging it with any ranges either side
+inline auto add_completed(Results &results, const std::size_t id) -> void {
+    auto &ranges = results.completed;
+    auto next = ranges.upper_bound(id);
+
+    if (next != ranges.begin()) {
+        const auto prev = std::prev(next);
+        if (prev->second > id) {
+            return;
+        }
+        if (prev->second == id) {
+            prev->second = id + 1;
+            if (next != ranges.end() && next->first == id + 1) {
+                prev->second = next->second;
+                ranges.erase(next);
+            }
+            return;
+        }
+    }
+
+    if (next != ranges.end() && next->first == id + 1) {
+        const auto last = next->second;
+        ranges.erase(next);
+        ranges.emplace(id, last);
+        return;
+    }
+
+    ranges.emplace(id, id + 1);
+}
+
+[[nodiscard]] inline auto is_completed(const Results &results, const std::size_t id) -> bool {
+    const auto next = results.completed.upper_bound(id);
+    return next != results.completed.begin() && std::prev(next)->second > id;
+}
+
+// Count a finished game towards the game pairs, once the other game on its opening with colours swapped is in
+// The two games of a pair can finish in either order, on any thread
+inline auto add_to_pairs(PairingScore &pairing, const std::size_t opening, const bool first_black, const int points)
+    -> void {
+    auto &waiting = pairing.unpaired[opening];
+
+    for (auto it = waiting.begin(); it != waiting.end(); ++it) {
+        if (it->first != first_black) {
+            pairing.pairs[it->second + points]++;
+            waiting.erase(it);
+            if (waiting.empty()) {
+                pairing.unpaired.erase(opening);
+            }
+            return;
+        }
+    }
+
+    waiting.emplace_back(first_black, points);
+}
+
+// The SPRT log likelihood ratio for the first engine of the pairing, over pairs of games or single games
+[[nodiscard]] inline auto get_sprt_llr(const PairingScore &pairing,
+                                       const bool pentanomial,
+                                       const float elo0,
+                                       const float elo1) -> float {
+    if (pentanomial) {
+        return sprt::get_llr_pentanomial(pairing.pairs, elo0, elo1);
+    }
+    return sprt::get_llr(pairing.wins, pairing.losses, pairing.draws, elo0, elo1);
+}
+
+// The time saved by not syncing, estimated from the average round trip where the engine was synced
+[[nodiscard]] inline auto estimated_sync_saving(const Score &score) -> std::chrono::milliseconds {
+    if (score.syncs == 0) {
+        return std::chrono::milliseconds(0);
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(score.sync_time * score.syncs_skipped / score.syncs);
+}
+
 inline std::ostream &operator<<(std::ostream &os, const Score &score) {
     const float points = score.wins + static_cast<float>(score.draws) / 2;
     os << score.wins << " - " << score.losses << " - " << score.draws;
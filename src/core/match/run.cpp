@@ -1,45 +1,189 @@
 #include "run.hpp"
+#include <algorithm>
+#include <bit>
+#include <exception>
 #include <memory>
 #include <stdexcept>
 #include <thread>
+#include <utility>
 #include <vector>
+#include "../affinity.hpp"
+#include "checkpoint.hpp"
+#include "reactor.hpp"
 #include "settings.hpp"
 #include "worker.hpp"
+// Engines
+#include "../engine/engine.hpp"
+#include "../engine/pool.hpp"
 // Tournaments
 #include "../tournament/gauntlet.hpp"
 #include "../tournament/generator.hpp"
 #include "../tournament/roundrobin.hpp"
 #include "../tournament/roundrobin_mixed.hpp"
+#include "../tournament/schedule.hpp"
+#include "../tournament/swiss.hpp"
 
-Results run(const Settings &settings, const std::vector<std::string> &openings, const Callbacks &callbacks) {
-    // Create results & initialise
-    Results results;
-    for (const auto &engine : settings.engines) {
-        results.scores[engine.name];
-    }
-
-    // Create tournament
-    std::shared_ptr<TournamentGenerator> game_generator;
+namespace {
 
+[[nodiscard]] auto make_generator(const Settings &settings, const std::size_t num_openings)
+    -> std::shared_ptr<TournamentGenerator> {
     if (settings.tournament_type == TournamentType::RoundRobin) {
-        game_generator =
-            std::make_shared<RoundRobinGenerator>(settings.engines.size(), settings.num_games, openings.size(), true);
+        return std::make_shared<RoundRobinGenerator>(settings.engines.size(), settings.num_games, num_openings, true);
     } else if (settings.tournament_type == TournamentType::Gauntlet) {
-        game_generator =
-            std::make_shared<GauntletGenerator>(settings.engines.size(), settings.num_games, openings.size(), true);
+        return std::make_shared<GauntletGenerator>(settings.engines.size(), settings.num_games, num_openings, true);
     } else if (settings.tournament_type == TournamentType::RoundRobinMixed) {
-        game_generator = std::make_shared<RoundRobinMixedGenerator>(
-            settings.engines.size(), settings.num_games, openings.size(), true);
+        return std::make_shared<RoundRobinMixedGenerator>(
+            settings.engines.size(), settings.num_games, num_openings, true);
     } else {
         throw std::runtime_error("Unknown tournament type");
     }
+}
+
+// Swiss pairings depend on results, so rather than being worked out up front they're made as the games are played
+[[nodiscard]] auto make_schedule(const Settings &settings, const std::size_t num_openings) -> Schedule {
+    if (settings.tournament_type == TournamentType::Swiss) {
+        const auto num_players = settings.engines.size();
+        const auto rounds = settings.rounds > 0 ? static_cast<std::size_t>(settings.rounds)
+                                                : std::max<std::size_t>(1, std::bit_width(num_players - 1));
+        return Schedule(std::make_unique<SwissGenerator>(
+            num_players, rounds, static_cast<std::size_t>(settings.num_games), num_openings));
+    }
+
+    const auto game_generator = make_generator(settings, num_openings);
+    return Schedule(*game_generator);
+}
+
+// Start the engines needed by the first games all at once and leave them in the pool,
+// rather than having every game wait on its own engines in turn
+auto prewarm(const Settings &settings,
+             const Schedule &schedule,
+             const std::size_t max_engines,
+             EnginePool &engine_pool,
+             const Callbacks &callbacks) -> void {
+    std::vector<const EngineSettings *> needed;
+
+    for (const auto &game_info : schedule.upcoming(static_cast<std::size_t>(settings.concurrency))) {
+        needed.push_back(&settings.engines.at(game_info.idx_player1));
+        needed.push_back(&settings.engines.at(game_info.idx_player2));
+    }
+
+    // No point starting more than the pool will keep
+    needed.resize(std::min(needed.size(), max_engines));
+
+    std::vector<std::shared_ptr<Engine>> engines(needed.size());
+    std::vector<std::exception_ptr> errors(needed.size());
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 0; i < needed.size(); ++i) {
+        threads.emplace_back([&, i]() {
+            try {
+                engines[i] = start_engine(*needed[i], settings, callbacks);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (const auto &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    for (std::size_t i = 0; i < needed.size(); ++i) {
+        engine_pool.checkin(needed[i]->id, std::move(engines[i]));
+    }
+}
+
+}  // namespace
+
+Results run(const Settings &settings,
+            const std::vector<std::string> &openings,
+            const Callbacks &callbacks,
+            Results results) {
+    // Initialise results
+    for (const auto &engine : settings.engines) {
+        results.scores[engine.name];
+    }
+
+    // Create tournament
+    Schedule schedule = make_schedule(settings, openings.size());
+
+    // Carry on where we left off. Games that were still being played are played again.
+    if (!results.completed.empty() || !results.pairings.empty()) {
+        if (settings.tournament_type == TournamentType::Swiss) {
+            throw std::invalid_argument("Swiss tournaments can't be resumed");
+        }
+
+        schedule.remove_if([&results](const GameInfo &game) {
+            return is_completed(results, game.id);
+        });
+
+        for (const auto &[engines, pairing] : results.pairings) {
+            if (pairing.decided) {
+                schedule.decide(engines.first, engines.second);
+            }
+        }
+    }
+
+    // Enough blocks that every thread has some to play, but no more than that
+    // Swiss pairings only have a game or two each, so there's nothing to group
+    if (settings.group_pairings && settings.tournament_type != TournamentType::Swiss) {
+        const auto block_size = schedule.size() / static_cast<std::size_t>(4 * settings.concurrency);
+        schedule.group_pairings(std::max<std::size_t>(2, block_size - block_size % 2));
+    }
+
+    // Idle engines are shared by every game, whichever thread it's played on
+    const auto max_idle = static_cast<std::size_t>(settings.idle_engines.value_or(2 * settings.concurrency));
+    EnginePool engine_pool(max_idle);
+
+    prewarm(settings, schedule, max_idle, engine_pool, callbacks);
+
+    // Every game being played gets its own CPUs
+    std::vector<std::vector<int>> slot_cpus(settings.concurrency);
+    if (settings.affinity) {
+        slot_cpus = make_slot_cpus(read_topology(), settings.concurrency, settings.avoid_smt);
+    }
 
     // Create threads
     std::vector<std::thread> threads;
 
-    // Start game threads
-    for (int i = 0; i < settings.concurrency; ++i) {
-        threads.emplace_back(worker, settings, openings, game_generator, std::ref(results), std::cref(callbacks));
+    if (settings.reactor) {
+        // Start one event loop per core, sharing the games between them
+        const auto num_cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        const auto num_loops = std::min(settings.concurrency, num_cores);
+
+        auto first_slot = slot_cpus.begin();
+        for (int i = 0; i < num_loops; ++i) {
+            const auto num_slots = settings.concurrency / num_loops + (i < settings.concurrency % num_loops);
+            const auto loop_cpus = std::vector<std::vector<int>>(first_slot, first_slot + num_slots);
+            first_slot += num_slots;
+
+            threads.emplace_back(reactor,
+                                 settings,
+                                 openings,
+                                 std::ref(schedule),
+                                 std::ref(engine_pool),
+                                 std::ref(results),
+                                 std::cref(callbacks),
+                                 loop_cpus);
+        }
+    } else {
+        // Start game threads
+        for (int i = 0; i < settings.concurrency; ++i) {
+            threads.emplace_back(worker,
+                                 settings,
+                                 openings,
+                                 std::ref(schedule),
+                                 std::ref(engine_pool),
+                                 std::ref(results),
+                                 std::cref(callbacks),
+                                 slot_cpus[i]);
+        }
     }
 
     // Wait for game threads to finish
@@ -49,5 +193,7 @@ Results run(const Settings &settings, const std::vector<std::string> &openings,
         }
     }
 
+    save_checkpoint(settings, results);
+
     return results;
 }
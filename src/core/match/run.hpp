@@ -8,6 +8,10 @@
 
 class Settings;
 
-Results run(const Settings &settings, const std::vector<std::string> &openings, const Callbacks &callbacks);
+// Carries on from the results given, such as those of a checkpoint, leaving out the games they already have
+Results run(const Settings &settings,
+            const std::vector<std::string> &openings,
+            const Callbacks &callbacks,
+            Results results = {});
 
 #endif
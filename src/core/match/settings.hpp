@@ -1,6 +1,7 @@
 #ifndef MATCH_SETTINGS_HPP
 #define MATCH_SETTINGS_HPP
 
+#include <cstdint>
 #include <optional>
 #include <ostream>
 #include <string>
@@ -16,18 +17,49 @@ struct SPRTSettings {
     float beta = 0.05f;
     float elo0 = 0.0f;
     float elo1 = 5.0f;
+    // Over pairs of games on the same opening rather than single games
+    bool pentanomial = false;
+};
+
+struct LogSettings {
+    // Engine logs are only written if this is set
+    std::string path;
+    std::size_t max_size = 10 * 1024 * 1024;
+};
+
+struct CheckpointSettings {
+    // Checkpoints are only written if this is set
+    std::string path;
+    // Games between checkpoints
+    int interval = 10;
 };
 
 struct Settings {
     int ratinginterval = 10;
     int concurrency = 1;
     int num_games = 100;
+    // Swiss rounds per engine, 0 for the usual ceil(log2(engines))
+    int rounds = 0;
     bool debug = false;
     bool recover = false;
+    // With recover, void games an engine crashes in and play them again, rather than restarting the engine mid-game
+    bool reschedule = false;
+    bool reactor = false;
+    bool affinity = false;
+    bool avoid_smt = false;
+    bool group_pairings = false;
     bool verbose = false;
     bool repeat = true;
     bool shuffle = false;
     bool print_early = true;
+    // Every game's seed is derived from this and the game's id, so a run or any one game can be replayed
+    std::uint64_t seed = 0;
+    // Of the settings file less the checkpoint settings, so that a checkpoint is only resumed with the same settings
+    std::uint64_t hash = 0;
+    // Defaults to twice the concurrency
+    std::optional<int> idle_engines;
+    // Stop playing engines once their Elo's 95% error bar is this narrow, with the game count as a cap
+    std::optional<float> precision;
     TournamentType tournament_type = TournamentType::RoundRobin;
     std::string openings_path;
     std::vector<EngineSettings> engines;
@@ -35,6 +67,8 @@ struct Settings {
     AdjudicationSettings adjudication;
     PGNSettings pgn;
     SPRTSettings sprt;
+    LogSettings logs;
+    CheckpointSettings checkpoint;
 };
 
 inline std::ostream &operator<<(std::ostream &os, const SearchSettings &ss) {
@@ -1,85 +1,417 @@
 #include "worker.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <elo.hpp>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <sprt.hpp>
 #include <thread>
-#include "../cache.hpp"
+#include <utility>
+#include "../affinity.hpp"
 #include "../play.hpp"
+#include "../play_builtin.hpp"
+#include "../rng.hpp"
+#include "checkpoint.hpp"
 #include "results.hpp"
 #include "settings.hpp"
 // Engines
 #include "../engine/create.hpp"
 #include "../engine/engine.hpp"
+#include "../engine/pool.hpp"
 // Tournaments
-#include "../tournament/generator.hpp"
-#include "../tournament/roundrobin.hpp"
+#include "../tournament/schedule.hpp"
 
 std::mutex mtx_output;
 std::mutex mtx_games;
 
-void worker(const Settings &settings,
-            const std::vector<std::string> &openings,
-            std::shared_ptr<TournamentGenerator> game_generator,
-            Results &results,
-            const Callbacks &callbacks) {
-    auto should_stop = false;
-    GameInfo game_info;
-    Cache<int, std::shared_ptr<Engine>> engine_cache(2);
+// Games voided by an engine crash, to be played again before any new ones
+// The count lets everyone skip the lock while there are none, which is almost always
+std::deque<GameInfo> rescheduled_games;
+std::map<std::size_t, int> num_reschedules;
+std::atomic<std::size_t> num_rescheduled = 0;
 
-    while (!should_stop) {
-        {
-            std::lock_guard<std::mutex> lock(mtx_games);
+// Checkpoints are taken under mtx_output but written after letting go of it, so nobody waits on the disk
+// Each is numbered as it's taken, so that one taken earlier can't replace a later one that got written first
+std::mutex mtx_checkpoint;
+std::uint64_t checkpoints_taken = 0;
+std::uint64_t checkpoints_written = 0;
 
-            // Return if we're out of things to do
-            if (game_generator->is_finished()) {
-                return;
-            }
+[[nodiscard]] auto next_game(Schedule &schedule, Schedule::Cursor &cursor) -> std::optional<GameInfo> {
+    if (num_rescheduled.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(mtx_games);
 
-            // Get the next game to play
-            game_info = game_generator->next();
+        if (!rescheduled_games.empty()) {
+            const auto game_info = rescheduled_games.front();
+            rescheduled_games.pop_front();
+            num_rescheduled--;
+            return game_info;
         }
+    }
 
-        const auto game = GameSettings(openings[game_info.idx_opening],
-                                       settings.engines[game_info.idx_player1],
-                                       settings.engines[game_info.idx_player2]);
+    return schedule.claim(cursor);
+}
 
-        callbacks.on_game_started(0, game.engine1.name, game.engine2.name);
+[[nodiscard]] auto start_engine(const EngineSettings &engine_settings,
+                                const Settings &settings,
+                                const Callbacks &callbacks) -> std::shared_ptr<Engine> {
+    callbacks.on_engine_start(engine_settings.name);
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    std::function<void(const std::string &msg)> send;
+    std::function<void(const std::string &msg)> recv;
+    std::function<void(const int fd)> err;
+
+    if (settings.debug) {
+        send = [on_info_send = callbacks.on_info_send, name = engine_settings.name](const std::string &msg) {
+            on_info_send(name, msg);
+        };
+        recv = [on_info_recv = callbacks.on_info_recv, name = engine_settings.name](const std::string &msg) {
+            on_info_recv(name, msg);
+        };
+    }
+
+    if (callbacks.on_engine_stderr) {
+        err = [on_engine_stderr = callbacks.on_engine_stderr, name = engine_settings.name](const int fd) {
+            on_engine_stderr(name, fd);
+        };
+    }
+
+    const auto engine = make_engine(engine_settings, send, recv, err);
+
+    const auto t1 = std::chrono::steady_clock::now();
+    callbacks.on_engine_ready(engine_settings.name, std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0));
+
+    return engine;
+}
+
+[[nodiscard]] auto get_engines(EnginePool &engine_pool,
+                               const GameSettings &game,
+                               const Settings &settings,
+                               const Callbacks &callbacks,
+                               const bool wait)
+    -> std::pair<std::shared_ptr<Engine>, std::shared_ptr<Engine>> {
+    // If the engines we need aren't idle in the pool, we get nothing
+    auto engine1 = engine_pool.checkout(game.engine1.id, wait);
+    auto engine2 = engine_pool.checkout(game.engine2.id, wait);
+
+    // Create new engine processes if necessary
+    if (!engine1) {
+        engine1 = start_engine(game.engine1, settings, callbacks);
+    }
+
+    if (!engine2) {
+        engine2 = start_engine(game.engine2, settings, callbacks);
+    }
+
+    return {engine1, engine2};
+}
+
+[[nodiscard]] auto make_restart(const Settings &settings,
+                                const Callbacks &callbacks,
+                                const GameSettings &game,
+                                std::shared_ptr<Engine> &engine1,
+                                std::shared_ptr<Engine> &engine2,
+                                const std::vector<int> &cpus) -> EngineRestart {
+    if (!settings.recover || settings.reschedule) {
+        return {};
+    }
+
+    return [&settings, &callbacks, &game, &engine1, &engine2, &cpus](const EngineSettings &engine_settings) {
+        auto engine = start_engine(engine_settings, settings, callbacks);
+        engine->set_affinity(cpus);
+        (engine_settings.id == game.engine1.id ? engine1 : engine2) = engine;
+        return engine;
+    };
+}
+
+[[nodiscard]] auto reschedule_game(const Settings &settings,
+                                   Results &results,
+                                   const GameInfo &game_info,
+                                   const GameSettings &game,
+                                   const GameThingy &game_data) -> bool {
+    if (!settings.recover || !settings.reschedule || game_data.reason != ResultReason::EngineCrash) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_games);
+
+        // An engine that crashes in the same game every time would otherwise hold up the match forever
+        if (num_reschedules[game_info.id]++ >= max_reschedules) {
+            return false;
+        }
+
+        rescheduled_games.push_back(game_info);
+        num_rescheduled++;
+    }
+
+    std::lock_guard<std::mutex> lock(mtx_output);
+    const auto &name = game_data.endpos.get_turn() == libataxx::Side::Black ? game.engine1.name : game.engine2.name;
+    results.scores[name].crashes++;
+
+    return true;
+}
+
+auto return_engines(EnginePool &engine_pool,
+                    const GameSettings &game,
+                    std::shared_ptr<Engine> engine1,
+                    std::shared_ptr<Engine> engine2) -> void {
+    engine_pool.checkin(game.engine1.id, std::move(engine1));
+    engine_pool.checkin(game.engine2.id, std::move(engine2));
+}
+
+auto report_search_info(const GameSettings &game, const GameThingy &game_data, const Callbacks &callbacks) -> void {
+    if (!callbacks.on_search_info || game_data.history.empty() || !game_data.history.back().info) {
+        return;
+    }
+
+    // The side to move has changed since
+    const auto &name = game_data.endpos.get_turn() == libataxx::Side::Black ? game.engine2.name : game.engine1.name;
+    callbacks.on_search_info(name, *game_data.history.back().info);
+}
+
+// Tell the schedule how a game went, for tournaments whose pairings depend on results
+auto report_result(Schedule &schedule, const GameInfo &game_info, const GameThingy &game_data) -> void {
+    switch (game_data.result) {
+        case libataxx::Result::BlackWin:
+            schedule.report(game_info, 1.0);
+            break;
+        case libataxx::Result::WhiteWin:
+            schedule.report(game_info, 0.0);
+            break;
+        default:
+            schedule.report(game_info, 0.5);
+            break;
+    }
+}
+
+[[nodiscard]] auto record_game(const Settings &settings,
+                               Results &results,
+                               Schedule &schedule,
+                               const GameInfo &game_info,
+                               const GameSettings &game,
+                               const GameThingy &game_data,
+                               const Callbacks &callbacks) -> bool {
+    report_result(schedule, game_info, game_data);
+
+    std::unique_lock<std::mutex> lock(mtx_output);
+
+    results.games_played++;
+
+    assert(results.games_played <= results.games_started);
+
+    // Update engine results
+    results.scores[game.engine1.name].played++;
+    results.scores[game.engine2.name].played++;
+
+    const auto add_sync = [](Score &score, const SyncThingy &sync) {
+        score.syncs += sync.count;
+        score.syncs_skipped += sync.skipped;
+        score.sync_time += sync.time;
+    };
+    add_sync(results.scores[game.engine1.name], game_data.sync1);
+    add_sync(results.scores[game.engine2.name], game_data.sync2);
+
+    // Crashes count whether they were recovered from or lost the game
+    results.scores[game.engine1.name].crashes += game_data.restarts1;
+    results.scores[game.engine2.name].crashes += game_data.restarts2;
+    if (game_data.reason == ResultReason::EngineCrash) {
+        const auto black_crashed = game_data.result == libataxx::Result::WhiteWin;
+        results.scores[black_crashed ? game.engine1.name : game.engine2.name].crashes++;
+    }
+
+    switch (game_data.result) {
+        case libataxx::Result::BlackWin:
+            results.scores[game.engine1.name].wins++;
+            results.scores[game.engine2.name].losses++;
+            results.black_wins++;
+            break;
+        case libataxx::Result::WhiteWin:
+            results.scores[game.engine1.name].losses++;
+            results.scores[game.engine2.name].wins++;
+            results.white_wins++;
+            break;
+        case libataxx::Result::Draw:
+            results.scores[game.engine1.name].draws++;
+            results.scores[game.engine2.name].draws++;
+            results.draws++;
+            break;
+        default:
+            break;
+    }
+
+    // Update pairing results, from the point of view of whichever engine comes first in the settings
+    const auto first_black = game_info.idx_player1 < game_info.idx_player2;
+    auto &pairing = results.pairings[std::minmax(game_info.idx_player1, game_info.idx_player2)];
+    if (game_data.result != libataxx::Result::None) {
+        const auto black_points = game_data.result == libataxx::Result::BlackWin  ? 2
+                                  : game_data.result == libataxx::Result::WhiteWin ? 0
+                                                                                   : 1;
+        const auto points = first_black ? black_points : 2 - black_points;
+        pairing.wins += points == 2;
+        pairing.losses += points == 0;
+        pairing.draws += points == 1;
+
+        // Pair up games on the same opening, however they're spread across threads
+        add_to_pairs(pairing, game_info.idx_opening, first_black, points);
+    }
 
-        // If the engines we need aren't in the cache, we get nothing
-        auto engine1 = engine_cache.get(game.engine1.id);
-        auto engine2 = engine_cache.get(game.engine2.id);
+    add_completed(results, game_info.id);
 
-        // Free resources by removing any engine processes left in the cache
-        engine_cache.clear();
+    // Write to .pgn
+    if (settings.pgn.enabled && !settings.pgn.path.empty()) {
+        write_as_pgn(settings.pgn, game.engine1.name, game.engine2.name, game_data);
+    }
+
+    // Check SPRT stop
+    // With more than two engines, each pairing is tested on its own and stops without holding up the rest
+    const auto is_sprt_stop = [&]() {
+        if (!settings.sprt.enabled || !settings.sprt.autostop) {
+            return false;
+        }
 
-        // Create new engine processes if necessary, knowing we have the resources available
-        if (!engine1) {
-            callbacks.on_engine_start(game.engine1.name);
+        // Other threads can still be finishing games after the match is decided, and have to stop as well
+        if (pairing.decided) {
+            return settings.engines.size() == 2;
+        }
 
-            if (settings.debug) {
-                engine1 = make_engine(game.engine1, callbacks.on_info_send, callbacks.on_info_recv);
-            } else {
-                engine1 = make_engine(game.engine1);
+        const auto llr = get_sprt_llr(pairing, settings.sprt.pentanomial, settings.sprt.elo0, settings.sprt.elo1);
+        const auto lbound = sprt::get_lbound(settings.sprt.alpha, settings.sprt.beta);
+        const auto ubound = sprt::get_ubound(settings.sprt.alpha, settings.sprt.beta);
+
+        if (llr > lbound && llr < ubound) {
+            return false;
+        }
+
+        pairing.decided = true;
+        schedule.decide(game_info.idx_player1, game_info.idx_player2);
+
+        if (settings.engines.size() == 2) {
+            return true;
+        }
+
+        if (callbacks.on_pairing_decided) {
+            const auto &[first, second] = std::minmax(game_info.idx_player1, game_info.idx_player2);
+            callbacks.on_pairing_decided(settings.engines.at(first).name, settings.engines.at(second).name, llr);
+        }
+        return false;
+    }();
+
+    // Stop playing engines whose Elo is already as precise as asked for
+    // A game is only skipped once both its engines are done, as it still narrows the error bar of either
+    const auto is_precise = [&](const std::size_t idx) {
+        const auto &score = results.scores.at(settings.engines.at(idx).name);
+        const auto err = get_err(score.wins, score.losses, score.draws);
+        // Without both a win and a loss, the error bar can't be trusted yet
+        return score.wins > 0 && score.losses > 0 && err <= *settings.precision;
+    };
+
+    auto is_precision_stop = false;
+    if (settings.precision) {
+        for (const auto player : {game_info.idx_player1, game_info.idx_player2}) {
+            if (!is_precise(player)) {
+                continue;
+            }
+            for (std::size_t other = 0; other < settings.engines.size(); ++other) {
+                if (other != player && is_precise(other)) {
+                    results.pairings[std::minmax(player, other)].decided = true;
+                    schedule.decide(player, other);
+                }
             }
         }
 
-        if (!engine2) {
-            callbacks.on_engine_start(game.engine2.name);
+        is_precision_stop = true;
+        for (std::size_t i = 0; i < settings.engines.size(); ++i) {
+            is_precision_stop &= is_precise(i);
+        }
+    }
+
+    // Taken while we still hold the lock, so the results and the games they cover match
+    std::optional<Checkpoint> checkpoint;
+    std::uint64_t checkpoint_number = 0;
+    if (!settings.checkpoint.path.empty() && results.games_played % settings.checkpoint.interval == 0) {
+        checkpoint = make_checkpoint(settings, results);
+        checkpoint_number = ++checkpoints_taken;
+    }
+
+    callbacks.on_results_update(results);
+
+    lock.unlock();
+
+    if (checkpoint) {
+        std::lock_guard<std::mutex> checkpoint_lock(mtx_checkpoint);
+        if (checkpoint_number > checkpoints_written) {
+            save_checkpoint(settings.checkpoint.path, *checkpoint);
+            checkpoints_written = checkpoint_number;
+        }
+    }
+
+    return is_sprt_stop || is_precision_stop;
+}
+
+void worker(const Settings &settings,
+            const std::vector<std::string> &openings,
+            Schedule &schedule,
+            EnginePool &engine_pool,
+            Results &results,
+            const Callbacks &callbacks,
+            const std::vector<int> &cpus) {
+    auto should_stop = false;
+
+    // Builtin engines play on this thread
+    pin_thread(cpus);
+
+    Schedule::Cursor cursor;
 
-            if (settings.debug) {
-                engine2 = make_engine(game.engine2, callbacks.on_info_send, callbacks.on_info_recv);
-            } else {
-                engine2 = make_engine(game.engine2);
+    while (!should_stop) {
+        const auto game_info = next_game(schedule, cursor);
+
+        // Return if we're out of things to do, unless more Swiss games are to come
+        if (!game_info) {
+            if (schedule.wait()) {
+                continue;
             }
+            return;
+        }
+
+        const auto game = GameSettings(openings[game_info->idx_opening],
+                                       settings.engines[game_info->idx_player1],
+                                       settings.engines[game_info->idx_player2],
+                                       derive_seed(settings.seed, game_info->id));
+
+        callbacks.on_game_started(0, game.engine1.name, game.engine2.name);
+
+        // Games between builtins don't need any engines
+        if (const auto game_data = play_builtin(settings.adjudication, game)) {
+            callbacks.on_game_finished(0, game.engine1.name, game.engine2.name);
+            should_stop |= record_game(settings, results, schedule, *game_info, game, *game_data, callbacks);
+            continue;
         }
 
+        auto [engine1, engine2] = get_engines(engine_pool, game, settings, callbacks);
+        engine1->set_affinity(cpus);
+        engine2->set_affinity(cpus);
+
         GameThingy game_data;
 
         // Play the game
         try {
-            game_data = play(settings.adjudication, game, *engine1, *engine2);
+            game_data = play(
+                settings.adjudication,
+                game,
+                engine1,
+                engine2,
+                [&game, &callbacks](GameThingy info, SearchSettings, SearchSettings) {
+                    report_search_info(game, info, callbacks);
+                    return true;
+                },
+                make_restart(settings, callbacks, game, engine1, engine2, cpus));
         } catch (std::invalid_argument &e) {
             std::cerr << e.what() << "\n";
         } catch (const char *e) {
@@ -90,71 +422,15 @@ void worker(const Settings &settings,
             std::cerr << "Error woops\n";
         }
 
-        engine_cache.push(game.engine1.id, *engine1);
-        engine_cache.push(game.engine2.id, *engine2);
-
-        (*engine1).reset();
-        (*engine2).reset();
+        return_engines(engine_pool, game, std::move(engine1), std::move(engine2));
 
         callbacks.on_game_finished(0, game.engine1.name, game.engine2.name);
 
-        // Results & printing
-        {
-            std::lock_guard<std::mutex> lock(mtx_output);
-
-            results.games_played++;
-
-            assert(results.games_played <= results.games_started);
-
-            // Update engine results
-            results.scores[game.engine1.name].played++;
-            results.scores[game.engine2.name].played++;
-
-            switch (game_data.result) {
-                case libataxx::Result::BlackWin:
-                    results.scores[game.engine1.name].wins++;
-                    results.scores[game.engine2.name].losses++;
-                    results.black_wins++;
-                    break;
-                case libataxx::Result::WhiteWin:
-                    results.scores[game.engine1.name].losses++;
-                    results.scores[game.engine2.name].wins++;
-                    results.white_wins++;
-                    break;
-                case libataxx::Result::Draw:
-                    results.scores[game.engine1.name].draws++;
-                    results.scores[game.engine2.name].draws++;
-                    results.draws++;
-                    break;
-                default:
-                    break;
-            }
-
-            // Write to .pgn
-            if (settings.pgn.enabled && !settings.pgn.path.empty()) {
-                write_as_pgn(settings.pgn, game.engine1.name, game.engine2.name, game_data);
-            }
-
-            // Check SPRT stop
-            const auto is_sprt_stop = [&settings, &results, &game]() {
-                if (!settings.sprt.enabled || !settings.sprt.autostop || settings.engines.size() != 2) {
-                    return false;
-                }
-
-                const auto w = results.scores.at(settings.engines.at(0).name).wins;
-                const auto l = results.scores.at(settings.engines.at(0).name).losses;
-                const auto d = results.scores.at(settings.engines.at(0).name).draws;
-                const auto llr = sprt::get_llr(w, l, d, settings.sprt.elo0, settings.sprt.elo1);
-                const auto lbound = sprt::get_lbound(settings.sprt.alpha, settings.sprt.beta);
-                const auto ubound = sprt::get_ubound(settings.sprt.alpha, settings.sprt.beta);
-
-                return llr <= lbound || llr >= ubound;
-            }();
-
-            // Stop the match
-            should_stop |= is_sprt_stop;
-
-            callbacks.on_results_update(results);
+        if (reschedule_game(settings, results, *game_info, game, game_data)) {
+            continue;
         }
+
+        // Results & printing
+        should_stop |= record_game(settings, results, schedule, *game_info, game, game_data, callbacks);
     }
 }
@@ -2,19 +2,82 @@
 #define MATCH_WORKER_HPP
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
-#include "../tournament/generator.hpp"
+#include "../play.hpp"
+#include "../tournament/schedule.hpp"
 #include "callbacks.hpp"
 
 class Settings;
 class Results;
-class GameSettings;
+class Engine;
+class EnginePool;
+
+// How many times a game voided by an engine crash is played again before the crash is allowed to decide it
+constexpr int max_reschedules = 3;
+
+// Get the next game to play, if there is one
+// Games voided by a crash come first, then the rest of the cursor's block if the schedule has blocks
+[[nodiscard]] auto next_game(Schedule &schedule, Schedule::Cursor &cursor) -> std::optional<GameInfo>;
+
+// Start a new engine process and wait until it's ready
+[[nodiscard]] auto start_engine(const EngineSettings &engine_settings,
+                                const Settings &settings,
+                                const Callbacks &callbacks) -> std::shared_ptr<Engine>;
+
+// Get the engines a game needs, reusing idle processes from the pool where possible
+// Without wait, idle engines aren't checked with isready before they're reused
+[[nodiscard]] auto get_engines(EnginePool &engine_pool,
+                               const GameSettings &game,
+                               const Settings &settings,
+                               const Callbacks &callbacks,
+                               const bool wait = true)
+    -> std::pair<std::shared_ptr<Engine>, std::shared_ptr<Engine>>;
+
+// How to replace a crashed engine mid-game, if the settings call for it
+// The replacement is also stored in engine1 or engine2, so it can be returned to the pool after the game
+[[nodiscard]] auto make_restart(const Settings &settings,
+                                const Callbacks &callbacks,
+                                const GameSettings &game,
+                                std::shared_ptr<Engine> &engine1,
+                                std::shared_ptr<Engine> &engine2,
+                                const std::vector<int> &cpus) -> EngineRestart;
+
+// Void a game lost to an engine crash and queue it to be played again, if the settings call for it
+// The crash is still counted. Returns false if the game should be recorded as usual
+[[nodiscard]] auto reschedule_game(const Settings &settings,
+                                   Results &results,
+                                   const GameInfo &game_info,
+                                   const GameSettings &game,
+                                   const GameThingy &game_data) -> bool;
+
+// Put engines back in the pool after a game, unless they've been killed
+auto return_engines(EnginePool &engine_pool,
+                    const GameSettings &game,
+                    std::shared_ptr<Engine> engine1,
+                    std::shared_ptr<Engine> engine2) -> void;
+
+// Pass on what the engine that just moved reported about its search
+auto report_search_info(const GameSettings &game, const GameThingy &game_data, const Callbacks &callbacks) -> void;
+
+// Update the results with a finished game, returning true if the match should stop
+// Also passes the result on to the schedule, and has it skip the rest of a pairing the SPRT has decided
+[[nodiscard]] auto record_game(const Settings &settings,
+                               Results &results,
+                               Schedule &schedule,
+                               const GameInfo &game_info,
+                               const GameSettings &game,
+                               const GameThingy &game_data,
+                               const Callbacks &callbacks) -> bool;
 
 void worker(const Settings &settings,
             const std::vector<std::string> &openings,
-            std::shared_ptr<TournamentGenerator> game_generator,
+            Schedule &schedule,
+            EnginePool &engine_pool,
             Results &results,
-            const Callbacks &callbacks);
+            const Callbacks &callbacks,
+            const std::vector<int> &cpus);
 
 #endif
@@ -1,14 +1,13 @@
 #include "openings.hpp"
 #include <algorithm>
-#include <ctime>
 #include <fstream>
-#include <random>
 #include <stdexcept>
 #include "../match/settings.hpp"
+#include "../rng.hpp"
 
 namespace parse {
 
-[[nodiscard]] std::vector<std::string> openings(const std::string &path, const bool shuffle) {
+[[nodiscard]] std::vector<std::string> openings(const std::string &path, const bool shuffle, const std::uint64_t seed) {
     std::ifstream f(path);
     std::vector<std::string> openings;
 
@@ -32,7 +31,7 @@ namespace parse {
     }
 
     if (shuffle) {
-        std::mt19937 rng(std::time(nullptr));
+        auto rng = Rng(seed);
         std::shuffle(openings.begin(), openings.end(), rng);
     }
 
@@ -1,12 +1,13 @@
 #ifndef PARSE_OPENINGS_HPP
 #define PARSE_OPENINGS_HPP
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace parse {
 
-[[nodiscard]] std::vector<std::string> openings(const std::string &path, const bool shuffle);
+[[nodiscard]] std::vector<std::string> openings(const std::string &path, const bool shuffle, const std::uint64_t seed);
 
 }  // namespace parse
 
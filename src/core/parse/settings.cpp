@@ -2,10 +2,33 @@
 #include <filesystem>
 #include <fstream>
 #include <nlohmann/json.hpp>
+#include <random>
 #include <stdexcept>
 
 namespace parse {
 
+// FNV-1a, which unlike std::hash gives the same hash on every platform and every run
+[[nodiscard]] auto hash_string(const std::string &str) -> std::uint64_t {
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    for (const auto c : str) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+[[nodiscard]] auto sync_policy(const std::string &str) -> SyncPolicy {
+    if (str == "move") {
+        return SyncPolicy::EveryMove;
+    } else if (str == "game") {
+        return SyncPolicy::NewGame;
+    } else if (str == "never") {
+        return SyncPolicy::Never;
+    } else {
+        throw std::invalid_argument("Unrecognised sync policy '" + str + "'");
+    }
+}
+
 [[nodiscard]] Settings settings(const std::string &path) {
     Settings settings;
     nlohmann::ordered_json json;
@@ -25,6 +48,13 @@ namespace parse {
         }
     }
 
+    // Where the checkpoint goes, and how often, doesn't change which games are played
+    {
+        auto hashed = json;
+        hashed.erase("checkpoint");
+        settings.hash = hash_string(hashed.dump());
+    }
+
     auto engine_iter = json.find("engines");
 
     // Basic checks
@@ -37,10 +67,14 @@ namespace parse {
     settings.tc.movetime = 10;
 
     std::vector<std::pair<std::string, std::string>> engine_options;
+    auto sync = SyncPolicy::EveryMove;
+    auto has_seed = false;
 
     for (const auto &[a, b] : json.items()) {
         if (a == "games") {
             settings.num_games = b.get<int>();
+        } else if (a == "rounds") {
+            settings.rounds = b.get<int>();
         } else if (a == "ratinginterval") {
             settings.ratinginterval = b.get<int>();
         } else if (a == "concurrency") {
@@ -51,8 +85,29 @@ namespace parse {
             settings.pgn.colour2 = b.get<std::string>();
         } else if (a == "debug") {
             settings.debug = b.get<bool>();
+        } else if (a == "sync") {
+            sync = sync_policy(b.get<std::string>());
+        } else if (a == "idle_engines") {
+            settings.idle_engines = b.get<int>();
+        } else if (a == "precision") {
+            settings.precision = b.get<float>();
+        } else if (a == "affinity") {
+            settings.affinity = b.get<bool>();
+        } else if (a == "avoid_smt") {
+            settings.avoid_smt = b.get<bool>();
+        } else if (a == "group_pairings") {
+            settings.group_pairings = b.get<bool>();
+        } else if (a == "recover") {
+            settings.recover = b.get<bool>();
+        } else if (a == "reschedule") {
+            settings.reschedule = b.get<bool>();
+        } else if (a == "reactor") {
+            settings.reactor = b.get<bool>();
         } else if (a == "verbose") {
             settings.verbose = b.get<bool>();
+        } else if (a == "seed") {
+            settings.seed = b.get<std::uint64_t>();
+            has_seed = true;
         } else if (a == "print_early") {
             settings.print_early = b.get<bool>();
         } else if (a == "tournament") {
@@ -64,6 +119,8 @@ namespace parse {
                 settings.tournament_type = TournamentType::RoundRobinMixed;
             } else if (tournament_type == "gauntlet") {
                 settings.tournament_type = TournamentType::Gauntlet;
+            } else if (tournament_type == "swiss") {
+                settings.tournament_type = TournamentType::Swiss;
             }
         } else if (a == "adjudicate") {
             for (const auto &[key, val] : b.items()) {
@@ -77,6 +134,22 @@ namespace parse {
                     settings.adjudication.timeout_buffer = val.get<int>();
                 }
             }
+        } else if (a == "checkpoint") {
+            for (const auto &[key, val] : b.items()) {
+                if (key == "path") {
+                    settings.checkpoint.path = val.get<std::string>();
+                } else if (key == "interval") {
+                    settings.checkpoint.interval = val.get<int>();
+                }
+            }
+        } else if (a == "logs") {
+            for (const auto &[key, val] : b.items()) {
+                if (key == "path") {
+                    settings.logs.path = val.get<std::string>();
+                } else if (key == "max_size") {
+                    settings.logs.max_size = val.get<std::size_t>();
+                }
+            }
         } else if (a == "openings") {
             for (const auto &[key, val] : b.items()) {
                 if (key == "path") {
@@ -139,6 +212,8 @@ namespace parse {
                     settings.sprt.elo0 = val.get<float>();
                 } else if (key == "elo1") {
                     settings.sprt.elo1 = val.get<float>();
+                } else if (key == "pentanomial") {
+                    settings.sprt.pentanomial = val.get<bool>();
                 }
             }
         } else if (a == "options") {
@@ -154,6 +229,7 @@ namespace parse {
         details.id = settings.engines.size();
         details.options = engine_options;
         details.tc = settings.tc;
+        details.sync = sync;
 
         for (const auto &[a, b] : engine.items()) {
             if (a == "path") {
@@ -166,6 +242,8 @@ namespace parse {
                     details.proto = EngineProtocol::FSF;
                 } else if (proto == "KATAGO" || proto == "KataGo" || proto == "katago") {
                     details.proto = EngineProtocol::KataGo;
+                } else if (proto == "PLUGIN" || proto == "plugin") {
+                    details.proto = EngineProtocol::Plugin;
                 }
             } else if (a == "name") {
                 details.name = b.get<std::string>();
@@ -173,6 +251,12 @@ namespace parse {
                 details.builtin = b.get<std::string>();
             } else if (a == "arguments") {
                 details.arguments = b.get<std::string>();
+            } else if (a == "send_moves") {
+                details.send_moves = b.get<bool>();
+            } else if (a == "sync") {
+                details.sync = sync_policy(b.get<std::string>());
+            } else if (a == "ponder") {
+                details.ponder = b.get<bool>();
             } else if (a == "options") {
                 for (const auto &[key, val] : b.items()) {
                     const auto iter =
@@ -219,6 +303,12 @@ namespace parse {
         settings.engines.emplace_back(details);
     }
 
+    // Runs without a seed get a random one, which is printed so they can still be replayed
+    if (!has_seed) {
+        std::random_device rd;
+        settings.seed = (static_cast<std::uint64_t>(rd()) << 32) | rd();
+    }
+
     // Check the paths given
     if (!std::filesystem::exists(settings.openings_path)) {
         throw std::runtime_error("Openings path not found: '" + settings.openings_path + "'");
@@ -244,6 +334,12 @@ namespace parse {
         throw std::invalid_argument("Must be at least 2 engines");
     } else if (settings.concurrency < 1) {
         throw std::invalid_argument("Must be at least 1 thread");
+    } else if (settings.idle_engines && *settings.idle_engines < 0) {
+        throw std::invalid_argument("Idle engine limit can't be negative");
+    } else if (settings.precision && *settings.precision <= 0.0f) {
+        throw std::invalid_argument("Precision must be positive");
+    } else if (settings.checkpoint.interval < 1) {
+        throw std::invalid_argument("Checkpoint interval must be at least 1");
     }
 
     return settings;
@@ -63,6 +63,7 @@ auto get_pgn(const PGNSettings &settings,
         f << "[Winner \"" << player2 << "\"]\n";
         f << "[Loser \"" << player1 << "\"]\n";
     }
+    f << "[Seed \"" << data.seed << "\"]\n";
     f << "[PlyCount \"" << data.history.size() << "\"]\n";
     f << "[Material \"" << (material_difference >= 0 ? "+" : "") << material_difference << "\"]\n";
     f << "\n";
@@ -85,6 +86,20 @@ auto get_pgn(const PGNSettings &settings,
         if (settings.verbose) {
             f << "{";
             f << " movetime " << info.movetime;
+            if (info.info) {
+                f << " depth " << info.info->depth;
+                f << " seldepth " << info.info->seldepth;
+                f << " nodes " << info.info->nodes;
+                f << " nps " << info.info->nps;
+                if (info.info->score_type == SearchInfo::ScoreType::Cp) {
+                    f << " score cp " << info.info->score;
+                } else if (info.info->score_type == SearchInfo::ScoreType::Mate) {
+                    f << " score mate " << info.info->score;
+                }
+                if (!info.info->pv.empty()) {
+                    f << " pv " << info.info->pv;
+                }
+            }
             f << " } ";
         }
 
@@ -1,12 +1,15 @@
 #ifndef PLAY_HPP
 #define PLAY_HPP
 
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <libataxx/move.hpp>
 #include <libataxx/position.hpp>
 #include <memory>
 #include <optional>
 #include <vector>
+#include "engine/search_info.hpp"
 #include "engine/settings.hpp"
 
 enum class ResultReason : int
@@ -28,6 +31,8 @@ struct GameSettings {
     std::string fen;
     EngineSettings engine1;
     EngineSettings engine2;
+    // For engines that play at random, see Engine::seed()
+    std::uint64_t seed = 0;
 };
 
 struct AdjudicationSettings {
@@ -40,6 +45,14 @@ struct AdjudicationSettings {
 struct MoveThingy {
     libataxx::Move move = libataxx::Move::nomove();
     int movetime = 0;
+    std::optional<SearchInfo> info;
+};
+
+// How often an engine was synced with isready, how long that took, and how many syncs its policy skipped
+struct SyncThingy {
+    int count = 0;
+    int skipped = 0;
+    std::chrono::microseconds time{0};
 };
 
 struct GameThingy {
@@ -48,8 +61,17 @@ struct GameThingy {
     std::vector<MoveThingy> history;
     libataxx::Position startpos;
     libataxx::Position endpos;
+    SyncThingy sync1;
+    SyncThingy sync2;
+    // Crashed engines that were restarted so the game could carry on
+    int restarts1 = 0;
+    int restarts2 = 0;
+    std::uint64_t seed = 0;
 };
 
+// Start a replacement for an engine that has crashed
+using EngineRestart = std::function<std::shared_ptr<Engine>(const EngineSettings &engine)>;
+
 [[nodiscard]] GameThingy play(
     const AdjudicationSettings &adjudication,
     const GameSettings &game,
@@ -58,6 +80,7 @@ struct GameThingy {
     std::function<bool(GameThingy info, SearchSettings tc1, SearchSettings tc2)> on_new_move_callback =
         []([[maybe_unused]] GameThingy info, [[maybe_unused]] SearchSettings tc1, [[maybe_unused]] SearchSettings tc2) {
             return true;
-        });
+        },
+    EngineRestart restart = {});
 
 #endif
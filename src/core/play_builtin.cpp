@@ -0,0 +1,105 @@
+#include "play_builtin.hpp"
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include "ataxx/adjudicate.hpp"
+#include "engine/builtin/least_captures.hpp"
+#include "engine/builtin/most_captures.hpp"
+#include "engine/builtin/movegen.hpp"
+#include "engine/builtin/random.hpp"
+#include "rng.hpp"
+
+namespace {
+
+using Builtin = std::variant<RandomBuiltin *, MostCapturesBuiltin *, LeastCapturesBuiltin *>;
+
+[[nodiscard]] auto get_builtin(const EngineSettings &engine) -> std::optional<Builtin> {
+    if (engine.builtin == "random") {
+        return static_cast<RandomBuiltin *>(nullptr);
+    } else if (engine.builtin == "mostcaptures") {
+        return static_cast<MostCapturesBuiltin *>(nullptr);
+    } else if (engine.builtin == "leastcaptures") {
+        return static_cast<LeastCapturesBuiltin *>(nullptr);
+    }
+    return {};
+}
+
+// Only the builtins that pick from a list of moves need the scratch space and randomness
+template <typename Builtin>
+[[nodiscard]] auto pick(const libataxx::Position &pos, MoveList &moves, Rng &rng) noexcept -> libataxx::Move {
+    if constexpr (requires { Builtin::pick(pos); }) {
+        return Builtin::pick(pos);
+    } else {
+        return Builtin::pick(pos, moves, rng);
+    }
+}
+
+// The same as Game, minus everything that only matters for engines that can take time, fail, or crash
+template <typename Black, typename White>
+[[nodiscard]] auto play_loop(const AdjudicationSettings &adjudication, const std::string &fen, const std::uint64_t seed)
+    -> GameThingy {
+    GameThingy info;
+    info.endpos = libataxx::Position{fen};
+    info.startpos = info.endpos;
+    info.seed = seed;
+
+    auto &pos = info.endpos;
+    // Scratch space for the builtins that pick from a list of moves
+    MoveList moves;
+    auto rng1 = Rng(derive_seed(seed, 1));
+    auto rng2 = Rng(derive_seed(seed, 2));
+
+    while (!pos.is_gameover()) {
+        if (adjudication.material && can_adjudicate_material(pos, *adjudication.material)) {
+            info.result = pos.get_turn() == libataxx::Side::Black ? libataxx::Result::BlackWin
+                                                                  : libataxx::Result::WhiteWin;
+            info.reason = ResultReason::MaterialImbalance;
+            return info;
+        }
+
+        if (adjudication.easyfill && can_adjudicate_easyfill(pos)) {
+            info.result = pos.get_turn() == libataxx::Side::Black ? libataxx::Result::WhiteWin
+                                                                  : libataxx::Result::BlackWin;
+            info.reason = ResultReason::EasyFill;
+            return info;
+        }
+
+        if (adjudication.gamelength && can_adjudicate_gamelength(pos, *adjudication.gamelength)) {
+            info.result = libataxx::Result::Draw;
+            info.reason = ResultReason::Gamelength;
+            return info;
+        }
+
+        const auto move = pos.get_turn() == libataxx::Side::Black ? pick<Black>(pos, moves, rng1)
+                                                                  : pick<White>(pos, moves, rng2);
+
+        info.history.push_back(MoveThingy{move, 0, std::nullopt});
+        pos.makemove(move);
+    }
+
+    info.result = pos.get_result();
+    return info;
+}
+
+}  // namespace
+
+[[nodiscard]] auto play_builtin(const AdjudicationSettings &adjudication, const GameSettings &game)
+    -> std::optional<GameThingy> {
+    const auto black = get_builtin(game.engine1);
+    const auto white = get_builtin(game.engine2);
+
+    if (!black || !white) {
+        return {};
+    }
+
+    // Every pairing of builtins gets its own loop
+    return std::visit(
+        [&adjudication, &game](auto *b, auto *w) {
+            using Black = std::remove_pointer_t<decltype(b)>;
+            using White = std::remove_pointer_t<decltype(w)>;
+            return play_loop<Black, White>(adjudication, game.fen, game.seed);
+        },
+        *black,
+        *white);
+}
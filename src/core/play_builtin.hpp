@@ -0,0 +1,13 @@
+#ifndef PLAY_BUILTIN_HPP
+#define PLAY_BUILTIN_HPP
+
+#include <optional>
+#include "play.hpp"
+
+// Play a game between two builtin engines without creating any, if that's what the game is
+// The builtins' moves are chosen directly, with no move strings or clocks involved, as they take no time anyway
+// Returns nothing if either player isn't a builtin
+[[nodiscard]] auto play_builtin(const AdjudicationSettings &adjudication, const GameSettings &game)
+    -> std::optional<GameThingy>;
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef RNG_HPP
+#define RNG_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Scrambles a number into one that looks unrelated, used to spread seeds out
+[[nodiscard]] constexpr auto splitmix64(std::uint64_t x) noexcept -> std::uint64_t {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// A seed of its own for the nth user of another seed, such as a game of a match or an engine in a game
+[[nodiscard]] constexpr auto derive_seed(const std::uint64_t seed, const std::uint64_t n) noexcept -> std::uint64_t {
+    return splitmix64(seed ^ splitmix64(n));
+}
+
+// xoshiro256**, cheap enough that every game and engine can have its own rather than sharing one between threads
+// Usable with the standard library as a UniformRandomBitGenerator
+class Rng {
+   public:
+    using result_type = std::uint64_t;
+
+    [[nodiscard]] explicit constexpr Rng(const std::uint64_t seed = 0) noexcept {
+        for (std::size_t i = 0; i < m_state.size(); ++i) {
+            m_state[i] = derive_seed(seed, i);
+        }
+    }
+
+    [[nodiscard]] static constexpr auto min() noexcept -> result_type {
+        return std::numeric_limits<result_type>::min();
+    }
+
+    [[nodiscard]] static constexpr auto max() noexcept -> result_type {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    constexpr auto operator()() noexcept -> result_type {
+        const auto result = rotl(m_state[1] * 5, 7) * 9;
+        const auto t = m_state[1] << 17;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+
+        return result;
+    }
+
+    // A number in [0, n), with a bias too small to matter for picking moves
+    [[nodiscard]] constexpr auto below(const std::uint64_t n) noexcept -> std::uint64_t {
+        return (*this)() % n;
+    }
+
+   private:
+    [[nodiscard]] static constexpr auto rotl(const std::uint64_t x, const int k) noexcept -> std::uint64_t {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::array<std::uint64_t, 4> m_state{};
+};
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef TOURNAMENT_SCHEDULE_HPP
+#define TOURNAMENT_SCHEDULE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "generator.hpp"
+#include "swiss.hpp"
+
+// Every game of a tournament, worked out before the first one starts
+// Games are claimed in order with a single atomic increment, so handing them out to threads takes no lock
+// Swiss tournaments can't be worked out in advance, so their games are paired under a lock as results are reported
+class [[nodiscard]] Schedule {
+   public:
+    // Where a worker is up to in the block of games it has claimed
+    struct Cursor {
+        std::size_t next = 0;
+        std::size_t end = 0;
+    };
+
+    explicit Schedule(std::vector<GameInfo> games, const std::size_t start = 0)
+        : m_games(std::move(games)), m_next(start) {
+        count_players();
+    }
+
+    explicit Schedule(TournamentGenerator &generator) : m_next(0) {
+        m_games.reserve(generator.expected());
+        while (!generator.is_finished()) {
+            m_games.push_back(generator.next());
+        }
+        count_players();
+    }
+
+    explicit Schedule(std::unique_ptr<SwissGenerator> swiss) : m_next(0), m_swiss(std::move(swiss)) {
+    }
+
+    Schedule(const Schedule &) = delete;
+    auto operator=(const Schedule &) -> Schedule & = delete;
+
+    // Leave out games, such as those already played before a restart. Only before any have been claimed.
+    template <typename Pred>
+    auto remove_if(Pred pred) -> void {
+        std::erase_if(m_games, pred);
+    }
+
+    // Put each pairing's games next to each other, in blocks of up to block_size games that are claimed whole
+    // Whoever plays a block can keep using the same engines for all of it, rather than starting new ones each game
+    auto group_pairings(const std::size_t block_size) -> void {
+        const auto pairing = [](const GameInfo &game) {
+            return std::minmax(game.idx_player1, game.idx_player2);
+        };
+
+        std::stable_sort(m_games.begin(), m_games.end(), [&pairing](const GameInfo &a, const GameInfo &b) {
+            return pairing(a) < pairing(b);
+        });
+
+        m_blocks.clear();
+        for (std::size_t i = 0; i < m_games.size(); ++i) {
+            const auto block_start = m_blocks.empty() ? 0 : m_blocks.back();
+            if (i == 0 || pairing(m_games[i]) != pairing(m_games[i - 1]) || i - block_start >= block_size) {
+                m_blocks.push_back(i);
+            }
+        }
+        m_blocks.push_back(m_games.size());
+    }
+
+    // The next game nobody has claimed yet, if there is one
+    [[nodiscard]] auto claim() -> std::optional<GameInfo> {
+        if (m_swiss) {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            if (!m_swiss->ready()) {
+                return {};
+            }
+            return m_swiss->next();
+        }
+
+        while (true) {
+            const auto idx = m_next.fetch_add(1, std::memory_order_relaxed);
+            if (idx >= m_games.size()) {
+                return {};
+            }
+            if (!is_decided(m_games[idx])) {
+                return m_games[idx];
+            }
+        }
+    }
+
+    // The same, but carrying on with the cursor's block first when games are grouped into blocks
+    [[nodiscard]] auto claim(Cursor &cursor) -> std::optional<GameInfo> {
+        if (m_blocks.empty()) {
+            return claim();
+        }
+
+        while (true) {
+            if (cursor.next == cursor.end) {
+                const auto block = m_next.fetch_add(1, std::memory_order_relaxed);
+                if (block + 1 >= m_blocks.size()) {
+                    return {};
+                }
+                cursor = Cursor{m_blocks[block], m_blocks[block + 1]};
+            }
+
+            const auto &game = m_games[cursor.next++];
+            if (!is_decided(game)) {
+                return game;
+            }
+        }
+    }
+
+    // Skip the rest of the games between two players, such as once the SPRT has decided the pairing
+    // Their games already claimed are still played
+    auto decide(const std::size_t player1, const std::size_t player2) noexcept -> void {
+        if (player1 < m_num_players && player2 < m_num_players) {
+            m_decided[player1 * m_num_players + player2].store(true, std::memory_order_relaxed);
+            m_decided[player2 * m_num_players + player1].store(true, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] auto is_decided(const GameInfo &game) const noexcept -> bool {
+        return m_num_players > 0 &&
+               m_decided[game.idx_player1 * m_num_players + game.idx_player2].load(std::memory_order_relaxed);
+    }
+
+    // Wait until there's another game to claim, returning false if there never will be
+    // Only Swiss games are ever worth waiting for, as they're paired once enough results are in
+    [[nodiscard]] auto wait() -> bool {
+        if (!m_swiss) {
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mtx);
+        m_cv.wait(lock, [this]() {
+            return m_swiss->ready() || m_swiss->is_finished();
+        });
+        return m_swiss->ready();
+    }
+
+    // Pass on the result of a finished game, with score being what player 1 got out of 1
+    auto report(const GameInfo &game, const double score) -> void {
+        if (!m_swiss) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_swiss->record(game, score);
+        }
+        m_cv.notify_all();
+    }
+
+    // The first game anyone will play, for up to n players
+    [[nodiscard]] auto upcoming(const std::size_t n) const -> std::vector<GameInfo> {
+        std::vector<GameInfo> games;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto idx = m_blocks.empty() ? i : i + 1 < m_blocks.size() ? m_blocks[i] : m_games.size();
+            if (idx >= m_games.size()) {
+                break;
+            }
+            games.push_back(m_games[idx]);
+        }
+        return games;
+    }
+
+    // How far through the schedule the games handed out so far go
+    [[nodiscard]] auto claimed() const noexcept -> std::size_t {
+        const auto next = m_next.load(std::memory_order_relaxed);
+        if (m_blocks.empty()) {
+            return std::min(next, m_games.size());
+        }
+        return m_blocks[std::min(next, m_blocks.size() - 1)];
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return m_games.size();
+    }
+
+    [[nodiscard]] auto operator[](const std::size_t idx) const noexcept -> const GameInfo & {
+        return m_games[idx];
+    }
+
+    [[nodiscard]] auto begin() const noexcept {
+        return m_games.begin();
+    }
+
+    [[nodiscard]] auto end() const noexcept {
+        return m_games.end();
+    }
+
+   private:
+    auto count_players() -> void {
+        for (const auto &game : m_games) {
+            m_num_players = std::max({m_num_players, game.idx_player1 + 1, game.idx_player2 + 1});
+        }
+        m_decided = std::make_unique<std::atomic<bool>[]>(m_num_players * m_num_players);
+    }
+
+    std::vector<GameInfo> m_games;
+    // Where each block starts, followed by the end of the last block. Empty unless games are grouped into blocks.
+    std::vector<std::size_t> m_blocks;
+    // The next game, or block, to hand out
+    std::atomic<std::size_t> m_next;
+    // Pairings whose games are skipped, indexed by player1 * m_num_players + player2
+    std::size_t m_num_players = 0;
+    std::unique_ptr<std::atomic<bool>[]> m_decided;
+    // Hands out games instead of m_games for Swiss tournaments
+    std::unique_ptr<SwissGenerator> m_swiss;
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+};
+
+#endif
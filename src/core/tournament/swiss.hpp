@@ -0,0 +1,227 @@
+#ifndef TOURNAMENT_SWISS_HPP
+#define TOURNAMENT_SWISS_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <tuple>
+#include <vector>
+#include "generator.hpp"
+
+// Pairs engines with others on a similar score, which ranks many engines in far fewer games than a round robin
+// Rather than waiting for a whole round to finish, two engines are paired as soon as both are free, preferring engines
+// on the same round, then the closest score. An engine only waits if every free opponent is one it's met more often than
+// some other engine that still has rounds to play. Each pairing plays num_games games with colours alternating and
+// openings shared in twos.
+// Pairings depend on results, so finished games have to be passed back with record(). next() can only be called while
+// ready(), and until is_finished() there may be more games once games in play are recorded.
+class [[nodiscard]] SwissGenerator : public TournamentGenerator {
+   public:
+    SwissGenerator(const std::size_t players,
+                   const std::size_t rounds,
+                   const std::size_t games,
+                   const std::size_t openings)
+        : num_players(players),
+          num_rounds(rounds),
+          num_games(games),
+          num_openings(openings),
+          players_info(players),
+          meetings(players * players, 0) {
+    }
+
+    virtual ~SwissGenerator() {
+    }
+
+    // No more games will be handed out, though some may still be in play
+    [[nodiscard]] virtual auto is_finished() -> bool override {
+        return !ready() && (in_play == 0 || num_unfinished() < 2);
+    }
+
+    [[nodiscard]] virtual auto expected() -> std::size_t override {
+        return num_players / 2 * num_rounds * num_games;
+    }
+
+    [[nodiscard]] virtual auto next() -> GameInfo override {
+        assert(ready());
+
+        if (queued.empty()) {
+            increment();
+        }
+
+        const auto result = queued.front();
+        queued.pop_front();
+        return result;
+    }
+
+    // Whether there's a game to hand out right now
+    [[nodiscard]] auto ready() const -> bool {
+        if (!queued.empty()) {
+            return true;
+        }
+        if (num_games == 0) {
+            return false;
+        }
+
+        const auto least = least_met();
+        for (std::size_t a = 0; a < num_players; ++a) {
+            for (std::size_t b = a + 1; b < num_players; ++b) {
+                if (can_pair(a, b, least)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Pass back the result of a game, with score being what player 1 got out of 1
+    auto record(const GameInfo &game, const double score) -> void {
+        auto &player1 = players_info[game.idx_player1];
+        auto &player2 = players_info[game.idx_player2];
+
+        assert(player1.pending > 0);
+        assert(player2.pending > 0);
+        assert(in_play > 0);
+
+        player1.points += score;
+        player2.points += 1.0 - score;
+        player1.played++;
+        player2.played++;
+        player1.pending--;
+        player2.pending--;
+        in_play--;
+    }
+
+    [[nodiscard]] auto points(const std::size_t player) const -> double {
+        return players_info.at(player).points;
+    }
+
+    [[nodiscard]] auto rounds(const std::size_t player) const -> std::size_t {
+        return players_info.at(player).rounds;
+    }
+
+   private:
+    struct Player {
+        std::size_t rounds = 0;
+        std::size_t played = 0;
+        // Games of the current round not yet recorded
+        std::size_t pending = 0;
+        double points = 0.0;
+    };
+
+    [[nodiscard]] auto is_idle(const Player &player) const noexcept -> bool {
+        return player.pending == 0 && player.rounds < num_rounds;
+    }
+
+    [[nodiscard]] auto num_unfinished() const noexcept -> std::size_t {
+        return static_cast<std::size_t>(std::count_if(players_info.begin(), players_info.end(), [this](const Player &p) {
+            return p.rounds < num_rounds;
+        }));
+    }
+
+    // The fewest times each engine has met any other engine that still has rounds to play
+    [[nodiscard]] auto least_met() const -> std::vector<std::size_t> {
+        std::vector<std::size_t> least(num_players, std::numeric_limits<std::size_t>::max());
+        for (std::size_t a = 0; a < num_players; ++a) {
+            for (std::size_t b = 0; b < num_players; ++b) {
+                if (a != b && players_info[b].rounds < num_rounds) {
+                    least[a] = std::min(least[a], meetings[a * num_players + b]);
+                }
+            }
+        }
+        return least;
+    }
+
+    // Both engines are free, and neither has anyone it's met less often still to play
+    // With no games in play, the two engines that have met least can always be paired, so nothing waits forever
+    [[nodiscard]] auto can_pair(const std::size_t a, const std::size_t b, const std::vector<std::size_t> &least) const
+        -> bool {
+        const auto met = meetings[a * num_players + b];
+        return a != b && is_idle(players_info[a]) && is_idle(players_info[b]) && met == least[a] && met == least[b];
+    }
+
+    // Points per game, so that engines a round apart can still be compared
+    [[nodiscard]] static auto average(const Player &player) noexcept -> double {
+        return player.played == 0 ? 0.5 : player.points / static_cast<double>(player.played);
+    }
+
+    // Pair the free engine that's furthest behind, the leader first if there's a tie, with its closest match
+    virtual auto increment() -> void override {
+        const auto least = least_met();
+        const auto has_partner = [&](const std::size_t player) {
+            for (std::size_t i = 0; i < num_players; ++i) {
+                if (can_pair(player, i, least)) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        std::vector<std::size_t> pairable;
+        for (std::size_t i = 0; i < num_players; ++i) {
+            if (has_partner(i)) {
+                pairable.push_back(i);
+            }
+        }
+
+        assert(pairable.size() >= 2);
+
+        const auto first = *std::min_element(
+            pairable.begin(), pairable.end(), [this](const std::size_t a, const std::size_t b) {
+                return std::make_tuple(players_info[a].rounds, -average(players_info[a]), a) <
+                       std::make_tuple(players_info[b].rounds, -average(players_info[b]), b);
+            });
+
+        const auto key = [this, first](const std::size_t player) {
+            return std::make_tuple(players_info[player].rounds != players_info[first].rounds,
+                                   std::abs(average(players_info[player]) - average(players_info[first])),
+                                   player);
+        };
+
+        auto second = first;
+        for (const auto player : pairable) {
+            if (can_pair(first, player, least) && (second == first || key(player) < key(second))) {
+                second = player;
+            }
+        }
+
+        meetings[first * num_players + second]++;
+        meetings[second * num_players + first]++;
+
+        for (const auto player : {first, second}) {
+            players_info[player].rounds++;
+            players_info[player].pending += num_games;
+        }
+        in_play += num_games;
+
+        for (std::size_t i = 0; i < num_games; ++i) {
+            const auto opening = (next_opening + i / 2) % num_openings;
+            if (i % 2 == 0) {
+                queued.push_back(GameInfo{idx++, opening, first, second});
+            } else {
+                queued.push_back(GameInfo{idx++, opening, second, first});
+            }
+        }
+
+        next_opening = (next_opening + (num_games + 1) / 2) % num_openings;
+    }
+
+    std::size_t num_players = 0;
+    std::size_t num_rounds = 0;
+    std::size_t num_games = 0;
+    std::size_t num_openings = 0;
+    // state
+    std::vector<Player> players_info;
+    // How many times each pair of engines has been paired, indexed by player1 * num_players + player2
+    std::vector<std::size_t> meetings;
+    // Games of the latest pairing that haven't been handed out yet
+    std::deque<GameInfo> queued;
+    // Games handed out or queued, but not recorded
+    std::size_t in_play = 0;
+    std::size_t idx = 0;
+    std::size_t next_opening = 0;
+};
+
+#endif
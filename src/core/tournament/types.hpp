@@ -6,6 +6,7 @@ enum class TournamentType
     RoundRobin,
     RoundRobinMixed,
     Gauntlet,
+    Swiss,
 };
 
 #endif
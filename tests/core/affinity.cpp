@@ -0,0 +1,60 @@
+#include "core/affinity.hpp"
+#include <doctest/doctest.h>
+#include <vector>
+
+TEST_SUITE("Affinity") {
+    TEST_CASE("Parse CPU list") {
+        REQUIRE(parse_cpu_list("") == std::vector<int>{});
+        REQUIRE(parse_cpu_list("3\n") == std::vector<int>{3});
+        REQUIRE(parse_cpu_list("0,4") == std::vector<int>{0, 4});
+        REQUIRE(parse_cpu_list("0-3,8,10-11") == std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+        REQUIRE(parse_cpu_list("4,0-1") == std::vector<int>{0, 1, 4});
+    }
+
+    TEST_CASE("Whole cores per slot") {
+        const std::vector<std::vector<int>> cores = {{0, 4}, {1, 5}, {2, 6}, {3, 7}};
+
+        const auto slots = make_slot_cpus(cores, 2, false);
+        REQUIRE(slots.size() == 2);
+        REQUIRE(slots[0] == std::vector<int>{0, 4, 1, 5});
+        REQUIRE(slots[1] == std::vector<int>{2, 6, 3, 7});
+
+        const auto uneven = make_slot_cpus(cores, 3, false);
+        REQUIRE(uneven[0] == std::vector<int>{0, 4});
+        REQUIRE(uneven[1] == std::vector<int>{1, 5});
+        REQUIRE(uneven[2] == std::vector<int>{2, 6, 3, 7});
+    }
+
+    TEST_CASE("Avoid SMT") {
+        const std::vector<std::vector<int>> cores = {{0, 4}, {1, 5}, {2, 6}, {3, 7}};
+
+        const auto slots = make_slot_cpus(cores, 4, true);
+        REQUIRE(slots[0] == std::vector<int>{0});
+        REQUIRE(slots[1] == std::vector<int>{1});
+        REQUIRE(slots[2] == std::vector<int>{2});
+        REQUIRE(slots[3] == std::vector<int>{3});
+    }
+
+    TEST_CASE("More slots than cores") {
+        const std::vector<std::vector<int>> cores = {{0, 2}, {1, 3}};
+
+        // Siblings get split up before slots have to share
+        const auto slots = make_slot_cpus(cores, 4, false);
+        REQUIRE(slots[0] == std::vector<int>{0});
+        REQUIRE(slots[1] == std::vector<int>{2});
+        REQUIRE(slots[2] == std::vector<int>{1});
+        REQUIRE(slots[3] == std::vector<int>{3});
+
+        const auto shared = make_slot_cpus(cores, 3, true);
+        REQUIRE(shared[0] == std::vector<int>{0});
+        REQUIRE(shared[1] == std::vector<int>{1});
+        REQUIRE(shared[2] == std::vector<int>{0});
+    }
+
+    TEST_CASE("No topology") {
+        const auto slots = make_slot_cpus({}, 2, false);
+        REQUIRE(slots.size() == 2);
+        REQUIRE(slots[0].empty());
+        REQUIRE(slots[1].empty());
+    }
+}
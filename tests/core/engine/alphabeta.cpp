@@ -0,0 +1,55 @@
+#include "core/engine/builtin/alphabeta.hpp"
+#include <doctest/doctest.h>
+#include <libataxx/position.hpp>
+#include <string>
+#include <utility>
+#include "core/ataxx/parse_move.hpp"
+
+TEST_SUITE("AlphaBetaBuiltin") {
+    TEST_CASE("Finds the win") {
+        auto pos = libataxx::Position("7/7/7/7/7/7/xo5 x 0 1");
+
+        AlphaBetaBuiltin engine;
+        engine.newgame();
+        engine.position(pos);
+        const auto movestr = engine.go(SearchSettings::as_depth(3), EngineClock::time_point::max());
+
+        pos.makemove(parse_move(movestr));
+        REQUIRE(!pos.get_white());
+
+        REQUIRE(engine.search_info());
+        REQUIRE(engine.search_info()->score_type == SearchInfo::ScoreType::Mate);
+        REQUIRE(engine.search_info()->score == 1);
+    }
+
+    TEST_CASE("Depth") {
+        const auto pos = libataxx::Position("startpos");
+
+        AlphaBetaBuiltin engine;
+        engine.position(pos);
+        const auto movestr = engine.go(SearchSettings::as_depth(4), EngineClock::time_point::max());
+
+        REQUIRE(pos.is_legal_move(parse_move(movestr)));
+        REQUIRE(engine.search_info()->depth == 4);
+        REQUIRE(engine.search_info()->score_type == SearchInfo::ScoreType::Cp);
+    }
+
+    TEST_CASE("Nodes are deterministic") {
+        const auto pos = libataxx::Position("x5o/7/2-1-2/7/2-1-2/7/o5x x 0 1");
+
+        const auto search = [&pos]() {
+            AlphaBetaBuiltin engine;
+            engine.newgame();
+            engine.position(pos);
+            const auto movestr = engine.go(SearchSettings::as_nodes(5'000), EngineClock::time_point::max());
+            return std::make_pair(movestr, engine.search_info()->nodes);
+        };
+
+        const auto [move1, nodes1] = search();
+        const auto [move2, nodes2] = search();
+        REQUIRE(pos.is_legal_move(parse_move(move1)));
+        REQUIRE(move1 == move2);
+        REQUIRE(nodes1 == nodes2);
+        REQUIRE(nodes1 >= 5'000);
+    }
+}
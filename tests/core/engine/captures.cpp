@@ -0,0 +1,89 @@
+#include "core/engine/builtin/captures.hpp"
+#include <doctest/doctest.h>
+#include <libataxx/position.hpp>
+#include <string>
+#include "core/engine/builtin/least_captures.hpp"
+#include "core/engine/builtin/most_captures.hpp"
+#include "core/engine/builtin/movegen.hpp"
+#include "core/rng.hpp"
+
+namespace {
+
+// The first move in the list with the best score, which is what the builtins did before batching their captures
+[[nodiscard]] auto reference(const libataxx::Position &pos, const bool most) -> libataxx::Move {
+    MoveList moves;
+    generate_moves(pos, moves);
+
+    auto best_score = -1'000;
+    auto best_move = libataxx::Move::nullmove();
+    for (const auto &move : moves) {
+        const auto score = (most ? 1 : -1) * (pos.count_captures(move) + move.is_single());
+        if (score > best_score) {
+            best_score = score;
+            best_move = move;
+        }
+    }
+    return best_move;
+}
+
+}  // namespace
+
+TEST_SUITE("Capture builtins") {
+    TEST_CASE("Capture counts") {
+        const std::string fens[] = {
+            "x5o/7/7/7/7/7/o5x x 0 1",
+            "x5o/7/2-1-2/7/2-1-2/7/o5x o 0 1",
+            "ooooooo/ooooooo/ooo1ooo/ooooooo/ooooooo/ooooooo/xxxxxxx x 0 1",
+            "o1o1o1o/1o1o1o1/o1o1o1o/1o1o1o1/o1o1o1o/1o1o1o1/o1o1o1x x 0 1",
+        };
+
+        for (const auto &fen : fens) {
+            const auto pos = libataxx::Position(fen);
+            const auto counts = CaptureCounts(pos.get_them());
+
+            for (const auto sq : ~libataxx::Bitboard()) {
+                const auto expected = (libataxx::Bitboard(sq).singles() & pos.get_them()).count();
+                for (int n = 0; n <= 8; ++n) {
+                    REQUIRE(static_cast<bool>(counts.equal(n) & libataxx::Bitboard(sq)) == (n == expected));
+                }
+            }
+        }
+    }
+
+    TEST_CASE("Double targets") {
+        const std::string fens[] = {
+            "x5o/7/7/7/7/7/o5x x 0 1",
+            "x5o/6o/2-1-2/7/2-1-2/5x1/o5x x 0 2",
+            "7/7/7/3x3/7/7/7 x 0 1",
+            "xxxxxxx/7/7/7/7/7/7 x 0 1",
+        };
+
+        for (const auto &fen : fens) {
+            const auto pos = libataxx::Position(fen);
+
+            auto expected = libataxx::Bitboard();
+            for (const auto from : pos.get_us()) {
+                expected |= libataxx::Bitboard(from).doubles();
+            }
+
+            REQUIRE(double_targets(pos.get_us()) == expected);
+        }
+    }
+
+    TEST_CASE("Same moves as scoring one at a time") {
+        auto rng = Rng(1);
+        MoveList moves;
+
+        for (int game = 0; game < 50; ++game) {
+            auto pos = libataxx::Position(game % 2 ? "startpos" : "x5o/7/2-1-2/7/2-1-2/7/o5x x 0 1");
+
+            while (!pos.is_gameover()) {
+                REQUIRE(MostCapturesBuiltin::pick(pos) == reference(pos, true));
+                REQUIRE(LeastCapturesBuiltin::pick(pos) == reference(pos, false));
+
+                generate_moves(pos, moves);
+                pos.makemove(moves[rng.below(moves.size())]);
+            }
+        }
+    }
+}
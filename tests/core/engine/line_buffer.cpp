@@ -0,0 +1,86 @@
+#include "core/engine/line_buffer.hpp"
+#include <doctest/doctest.h>
+#include <unistd.h>
+#include <string>
+#include <string_view>
+
+TEST_SUITE("LineBuffer") {
+    TEST_CASE("Lines split across reads") {
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+
+        LineBuffer buffer;
+        REQUIRE(!buffer.next_line());
+
+        const std::string_view part1 = "uaiok\r\nreadyok\nbestm";
+        REQUIRE(write(fds[1], part1.data(), part1.size()) == static_cast<ssize_t>(part1.size()));
+        REQUIRE(buffer.fill(fds[0]) == static_cast<ssize_t>(part1.size()));
+
+        REQUIRE(buffer.next_line() == "uaiok");
+        REQUIRE(buffer.next_line() == "readyok");
+        REQUIRE(!buffer.next_line());
+
+        const std::string_view part2 = "ove a1\n\n";
+        REQUIRE(write(fds[1], part2.data(), part2.size()) == static_cast<ssize_t>(part2.size()));
+        REQUIRE(buffer.fill(fds[0]) == static_cast<ssize_t>(part2.size()));
+
+        REQUIRE(buffer.next_line() == "bestmove a1");
+        REQUIRE(buffer.next_line() == "");
+        REQUIRE(!buffer.next_line());
+
+        close(fds[1]);
+        REQUIRE(buffer.fill(fds[0]) == 0);
+        close(fds[0]);
+    }
+
+    TEST_CASE("Wrap around") {
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+
+        LineBuffer buffer;
+        const auto line = std::string(1000, 'x') + "\n";
+        auto num_lines = 0;
+
+        // Enough data to go around the buffer several times, with lines straddling the end of it
+        for (int i = 0; i < 300; ++i) {
+            REQUIRE(write(fds[1], line.data(), line.size()) == static_cast<ssize_t>(line.size()));
+            REQUIRE(buffer.fill(fds[0]) > 0);
+
+            while (const auto got = buffer.next_line()) {
+                REQUIRE(got->size() == 1000);
+                num_lines++;
+            }
+        }
+
+        REQUIRE(num_lines == 300);
+
+        close(fds[1]);
+        close(fds[0]);
+    }
+
+    TEST_CASE("Overlong line") {
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+
+        LineBuffer buffer;
+        const auto chunk = std::string(1024, 'x');
+
+        for (std::size_t i = 0; i < LineBuffer::capacity / chunk.size(); ++i) {
+            REQUIRE(!buffer.next_line());
+            REQUIRE(write(fds[1], chunk.data(), chunk.size()) == static_cast<ssize_t>(chunk.size()));
+            REQUIRE(buffer.fill(fds[0]) == static_cast<ssize_t>(chunk.size()));
+        }
+
+        // The full buffer is handed out as a line of its own
+        REQUIRE(buffer.next_line()->size() == LineBuffer::capacity);
+        REQUIRE(!buffer.next_line());
+
+        const std::string_view end = "xyz\n";
+        REQUIRE(write(fds[1], end.data(), end.size()) == static_cast<ssize_t>(end.size()));
+        REQUIRE(buffer.fill(fds[0]) == static_cast<ssize_t>(end.size()));
+        REQUIRE(buffer.next_line() == "xyz");
+
+        close(fds[1]);
+        close(fds[0]);
+    }
+}
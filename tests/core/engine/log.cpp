@@ -0,0 +1,89 @@
+#include "core/engine/log.hpp"
+#include <doctest/doctest.h>
+#include <unistd.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+[[nodiscard]] auto read_lines(const std::filesystem::path &path) -> std::vector<std::string> {
+    std::vector<std::string> lines;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+[[nodiscard]] auto make_dir(const std::string &name) -> std::filesystem::path {
+    const auto dir = std::filesystem::temp_directory_path() / ("cuteataxx-" + name + "-" + std::to_string(getpid()));
+    std::filesystem::remove_all(dir);
+    return dir;
+}
+
+}  // namespace
+
+TEST_SUITE("EngineLog") {
+    TEST_CASE("Lines and captured output") {
+        const auto dir = make_dir("log");
+
+        {
+            EngineLog log(dir, 1024);
+
+            int fds[2];
+            REQUIRE(pipe(fds) == 0);
+            log.capture("Engine/1", fds[0]);
+
+            log.write("Engine/1", "> uai");
+            log.write("Engine 2", "< uaiok");
+            REQUIRE(::write(fds[1], "some\nstderr\n", 12) == 12);
+            close(fds[1]);
+        }
+
+        // Everything is written out before the log is destroyed, and names are made safe to use as filenames
+        REQUIRE(read_lines(dir / "Engine 2.log") == std::vector<std::string>{"< uaiok"});
+
+        // Captured lines keep their order, but can come either side of lines written directly
+        auto lines = read_lines(dir / "Engine_1.log");
+        REQUIRE(lines.size() == 3);
+        lines.erase(std::remove(lines.begin(), lines.end(), "> uai"), lines.end());
+        REQUIRE(lines == std::vector<std::string>{"some", "stderr"});
+
+        std::filesystem::remove_all(dir);
+    }
+
+    TEST_CASE("Rotation") {
+        const auto dir = make_dir("rotate");
+
+        {
+            EngineLog log(dir, 16);
+            for (int i = 0; i < 10; ++i) {
+                log.write("Engine", "line " + std::to_string(i));
+            }
+        }
+
+        // Each file only has room for two lines
+        REQUIRE(read_lines(dir / "Engine.log.1") == std::vector<std::string>{"line 6", "line 7"});
+        REQUIRE(read_lines(dir / "Engine.log") == std::vector<std::string>{"line 8", "line 9"});
+
+        std::filesystem::remove_all(dir);
+    }
+
+    TEST_CASE("Full queue") {
+        const auto dir = make_dir("full");
+
+        {
+            EngineLog log(dir, 1024, 0);
+            log.write("Engine", "dropped");
+            REQUIRE(log.num_dropped() == 1);
+        }
+
+        REQUIRE(read_lines(dir / "Engine.log").empty());
+
+        std::filesystem::remove_all(dir);
+    }
+}
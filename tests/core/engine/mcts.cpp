@@ -0,0 +1,51 @@
+#include "core/engine/builtin/mcts.hpp"
+#include <doctest/doctest.h>
+#include <libataxx/position.hpp>
+#include <string>
+#include <utility>
+#include "core/ataxx/parse_move.hpp"
+
+TEST_SUITE("MCTSBuiltin") {
+    TEST_CASE("Finds the win") {
+        auto pos = libataxx::Position("7/7/7/7/7/7/xo5 x 0 1");
+
+        MCTSBuiltin engine;
+        engine.newgame();
+        engine.position(pos);
+        const auto movestr = engine.go(SearchSettings::as_nodes(2'000), EngineClock::time_point::max());
+
+        pos.makemove(parse_move(movestr));
+        REQUIRE(!pos.get_white());
+        REQUIRE(engine.search_info()->score > 0);
+    }
+
+    TEST_CASE("Nodes are deterministic") {
+        const auto pos = libataxx::Position("x5o/7/2-1-2/7/2-1-2/7/o5x x 0 1");
+
+        const auto search = [&pos]() {
+            MCTSBuiltin engine;
+            engine.newgame();
+            engine.position(pos);
+            const auto movestr = engine.go(SearchSettings::as_nodes(4'000), EngineClock::time_point::max());
+            return std::make_pair(movestr, engine.search_info()->score);
+        };
+
+        const auto [move1, score1] = search();
+        const auto [move2, score2] = search();
+        REQUIRE(pos.is_legal_move(parse_move(move1)));
+        REQUIRE(move1 == move2);
+        REQUIRE(score1 == score2);
+    }
+
+    TEST_CASE("Movetime") {
+        const auto pos = libataxx::Position("startpos");
+
+        MCTSBuiltin engine;
+        engine.position(pos);
+        const auto movestr = engine.go(SearchSettings::as_movetime(50), EngineClock::time_point::max());
+
+        REQUIRE(pos.is_legal_move(parse_move(movestr)));
+        REQUIRE(engine.search_info()->nodes > 0);
+        REQUIRE(engine.search_info()->time < 1000);
+    }
+}
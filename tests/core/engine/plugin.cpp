@@ -0,0 +1,36 @@
+#include "core/engine/plugin.hpp"
+#include <doctest/doctest.h>
+#include <libataxx/position.hpp>
+#include <memory>
+#include "core/engine/create.hpp"
+#include "core/engine/settings.hpp"
+
+TEST_SUITE("PluginEngine") {
+    TEST_CASE("Search") {
+        auto settings = EngineSettings{
+            0, EngineProtocol::Plugin, "Plugin", "", TEST_PLUGIN_PATH, "", SearchSettings::as_depth(1), {{"reply", "b2"}}};
+        const auto engine = make_engine(settings);
+
+        // Nothing to search yet
+        REQUIRE_THROWS(engine->go(SearchSettings::as_depth(1), EngineClock::time_point::max()));
+
+        engine->newgame();
+        engine->position(libataxx::Position("startpos"));
+        REQUIRE(engine->go(SearchSettings::as_depth(1), EngineClock::time_point::max()) == "b2");
+        REQUIRE(engine->go(SearchSettings::as_movetime(35), EngineClock::time_point::max()) == "35");
+
+        // Every engine gets its own instance
+        settings.options.clear();
+        const auto other = make_engine(settings);
+        other->position(libataxx::Position("startpos"));
+        REQUIRE(other->go(SearchSettings::as_depth(1), EngineClock::time_point::max()) == "0000");
+        REQUIRE(engine->go(SearchSettings::as_depth(1), EngineClock::time_point::max()) == "b2");
+    }
+
+    TEST_CASE("Errors") {
+        REQUIRE_THROWS(PluginEngine("/nonexistent/plugin.so"));
+
+        PluginEngine engine(TEST_PLUGIN_PATH);
+        REQUIRE_THROWS(engine.set_option("unknown", "1"));
+    }
+}
@@ -0,0 +1,68 @@
+#include "core/engine/pool.hpp"
+#include <doctest/doctest.h>
+#include <memory>
+#include <stdexcept>
+#include "core/engine/builtin/most_captures.hpp"
+
+// Still running, but never answers isready
+class UnresponsiveEngine : public MostCapturesBuiltin {
+   public:
+    virtual auto isready() -> void override {
+        throw std::runtime_error("Engine failed to respond in time");
+    }
+};
+
+TEST_SUITE("EnginePool") {
+    TEST_CASE("Checkout by id") {
+        EnginePool pool(4);
+        const auto engine1 = std::make_shared<MostCapturesBuiltin>();
+        const auto engine2 = std::make_shared<MostCapturesBuiltin>();
+
+        REQUIRE(!pool.checkout(0));
+
+        pool.checkin(0, engine1);
+        pool.checkin(1, engine2);
+        REQUIRE(pool.num_idle() == 2);
+
+        REQUIRE(!pool.checkout(2));
+        REQUIRE(pool.checkout(1) == engine2);
+        REQUIRE(!pool.checkout(1));
+        REQUIRE(pool.checkout(0) == engine1);
+        REQUIRE(pool.num_idle() == 0);
+    }
+
+    TEST_CASE("Idle limit") {
+        EnginePool pool(2);
+        const auto engine1 = std::make_shared<MostCapturesBuiltin>();
+        const auto engine2 = std::make_shared<MostCapturesBuiltin>();
+        const auto engine3 = std::make_shared<MostCapturesBuiltin>();
+
+        pool.checkin(0, engine1);
+        pool.checkin(1, engine2);
+        pool.checkin(2, engine3);
+        REQUIRE(pool.num_idle() == 2);
+
+        // The longest idle engine goes first
+        REQUIRE(!pool.checkout(0));
+        REQUIRE(pool.checkout(1) == engine2);
+        REQUIRE(pool.checkout(2) == engine3);
+    }
+
+    TEST_CASE("No idle engines") {
+        EnginePool pool(0);
+        pool.checkin(0, std::make_shared<MostCapturesBuiltin>());
+        REQUIRE(pool.num_idle() == 0);
+        REQUIRE(!pool.checkout(0));
+    }
+
+    TEST_CASE("Checkout without waiting") {
+        EnginePool pool(4);
+        const auto engine = std::make_shared<UnresponsiveEngine>();
+
+        // Only an engine that's checked with isready gets turned away
+        pool.checkin(0, engine);
+        REQUIRE(!pool.checkout(0));
+        pool.checkin(0, engine);
+        REQUIRE(pool.checkout(0, false) == engine);
+    }
+}
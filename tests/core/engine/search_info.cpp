@@ -0,0 +1,61 @@
+#include "core/engine/search_info.hpp"
+#include <doctest/doctest.h>
+
+TEST_SUITE("SearchInfo") {
+    TEST_CASE("Full info line") {
+        const auto info = parse_info("info depth 12 seldepth 17 score cp -35 nodes 123456 nps 987654 time 125 pv a1 b2c4 g7");
+        REQUIRE(info);
+        REQUIRE(info->depth == 12);
+        REQUIRE(info->seldepth == 17);
+        REQUIRE(info->score_type == SearchInfo::ScoreType::Cp);
+        REQUIRE(info->score == -35);
+        REQUIRE(info->nodes == 123456);
+        REQUIRE(info->nps == 987654);
+        REQUIRE(info->time == 125);
+        REQUIRE(info->pv == "a1 b2c4 g7");
+    }
+
+    TEST_CASE("Mate score") {
+        const auto info = parse_info("info depth 5 score mate -3");
+        REQUIRE(info);
+        REQUIRE(info->score_type == SearchInfo::ScoreType::Mate);
+        REQUIRE(info->score == -3);
+        REQUIRE(info->pv.empty());
+    }
+
+    TEST_CASE("Ignored lines") {
+        REQUIRE(!parse_info(""));
+        REQUIRE(!parse_info("bestmove a1"));
+        REQUIRE(!parse_info("info string depth 5"));
+        REQUIRE(!parse_info("info currmove a1 currmovenumber 1"));
+        REQUIRE(!parse_info("info nodes 100 nps 1000"));
+        REQUIRE(!parse_info("informative depth 5"));
+    }
+
+    TEST_CASE("Info line kept until the search is over") {
+        InfoLine line;
+        REQUIRE(!line.parse());
+
+        REQUIRE(line.keep("info depth 1 score cp 10 pv a1"));
+        REQUIRE(line.keep("info depth 2 score cp 20 pv a1 b2"));
+        REQUIRE(!line.keep("info currmove a1 currmovenumber 1"));
+        REQUIRE(!line.keep("bestmove a1"));
+
+        // Only the last useful line counts
+        const auto info = line.parse();
+        REQUIRE(info);
+        REQUIRE(info->depth == 2);
+        REQUIRE(info->score == 20);
+        REQUIRE(info->pv == "a1 b2");
+
+        line.clear();
+        REQUIRE(!line.parse());
+    }
+
+    TEST_CASE("Info line without pv") {
+        const auto info = parse_info("info depth 3 score cp 5 pv a1 b2", false);
+        REQUIRE(info);
+        REQUIRE(info->depth == 3);
+        REQUIRE(info->pv.empty());
+    }
+}
@@ -0,0 +1,56 @@
+#include <cstring>
+#include <string>
+#include "core/engine/plugin_api.h"
+
+// Plays whatever move it was told to with the "reply" option, and remembers what it was asked
+struct TestPlugin {
+    std::string reply = "0000";
+    std::string fen;
+    int movetime = 0;
+};
+
+extern "C" {
+
+int cuteataxx_plugin_version(void) {
+    return CUTEATAXX_PLUGIN_VERSION;
+}
+
+void *cuteataxx_create(void) {
+    return new TestPlugin();
+}
+
+void cuteataxx_destroy(void *engine) {
+    delete static_cast<TestPlugin *>(engine);
+}
+
+int cuteataxx_set_option(void *engine, const char *name, const char *value) {
+    if (std::strcmp(name, "reply") != 0) {
+        return 1;
+    }
+    static_cast<TestPlugin *>(engine)->reply = value;
+    return 0;
+}
+
+int cuteataxx_newgame(void *engine) {
+    static_cast<TestPlugin *>(engine)->fen.clear();
+    return 0;
+}
+
+int cuteataxx_position(void *engine, const char *fen) {
+    static_cast<TestPlugin *>(engine)->fen = fen;
+    return 0;
+}
+
+// Fails without a position, and sends the movetime back as the move for movetime searches
+int cuteataxx_go(void *engine, const struct cuteataxx_search *search, char *move, size_t size) {
+    const auto &plugin = *static_cast<TestPlugin *>(engine);
+    if (plugin.fen.empty()) {
+        return 1;
+    }
+
+    const auto movestr =
+        search->type == CUTEATAXX_SEARCH_MOVETIME ? std::to_string(search->movetime) : plugin.reply;
+    std::strncpy(move, movestr.c_str(), size);
+    return 0;
+}
+}
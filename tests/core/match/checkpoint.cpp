@@ -0,0 +1,139 @@
+#include "core/match/checkpoint.hpp"
+#include <doctest/doctest.h>
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "core/match/settings.hpp"
+
+namespace {
+
+[[nodiscard]] auto make_path(const std::string &name) -> std::filesystem::path {
+    const auto path =
+        std::filesystem::temp_directory_path() / ("cuteataxx-" + name + "-" + std::to_string(getpid()) + ".txt");
+    std::filesystem::remove(path);
+    return path;
+}
+
+}  // namespace
+
+TEST_SUITE("Checkpoint") {
+    TEST_CASE("Completed ranges") {
+        Results results;
+
+        for (const auto id : {3, 1, 0, 7, 2, 5, 6}) {
+            add_completed(results, id);
+        }
+        add_completed(results, 2);
+
+        REQUIRE(results.completed == std::map<std::size_t, std::size_t>{{0, 4}, {5, 8}});
+        REQUIRE(is_completed(results, 0));
+        REQUIRE(is_completed(results, 3));
+        REQUIRE(!is_completed(results, 4));
+        REQUIRE(is_completed(results, 7));
+        REQUIRE(!is_completed(results, 8));
+
+        add_completed(results, 4);
+        REQUIRE(results.completed == std::map<std::size_t, std::size_t>{{0, 8}});
+    }
+
+    TEST_CASE("Round trip") {
+        const auto path = make_path("checkpoint");
+
+        Checkpoint checkpoint;
+        checkpoint.settings_hash = 0xDEADBEEFCAFEF00DULL;
+        checkpoint.seed = 18446744073709551557ULL;
+
+        auto &results = checkpoint.results;
+        results.games_played = 7;
+        results.black_wins = 4;
+        results.white_wins = 2;
+        results.draws = 1;
+        results.scores["engine one"] = Score{.wins = 5, .draws = 1, .losses = 1, .crashes = 2, .played = 7};
+        results.scores["engine one"].sync_time = std::chrono::microseconds(1234);
+        results.scores["two"] = Score{.wins = 1, .draws = 1, .losses = 5, .played = 7};
+        auto &pairing = results.pairings[{0, 1}];
+        pairing.wins = 5;
+        pairing.losses = 1;
+        pairing.draws = 1;
+        pairing.pairs = {0, 1, 0, 2, 0};
+        pairing.decided = true;
+        add_to_pairs(pairing, 12, true, 2);
+        for (const auto id : {0, 1, 2, 3, 4, 6, 9}) {
+            add_completed(results, id);
+        }
+        checkpoint.pgn_size = 4321;
+
+        save_checkpoint(path.string(), checkpoint);
+        REQUIRE(!std::filesystem::exists(path.string() + ".tmp"));
+
+        const auto loaded = load_checkpoint(path.string());
+        REQUIRE(loaded.settings_hash == checkpoint.settings_hash);
+        REQUIRE(loaded.seed == checkpoint.seed);
+        REQUIRE(loaded.results.games_played == 7);
+        REQUIRE(loaded.results.black_wins == 4);
+        REQUIRE(loaded.results.white_wins == 2);
+        REQUIRE(loaded.results.draws == 1);
+        REQUIRE(loaded.results.scores.size() == 2);
+        REQUIRE(loaded.results.scores.at("engine one").wins == 5);
+        REQUIRE(loaded.results.scores.at("engine one").crashes == 2);
+        REQUIRE(loaded.results.scores.at("engine one").sync_time == std::chrono::microseconds(1234));
+        REQUIRE(loaded.results.scores.at("two").losses == 5);
+
+        const auto &loaded_pairing = loaded.results.pairings.at({0, 1});
+        REQUIRE(loaded_pairing.wins == 5);
+        REQUIRE(loaded_pairing.losses == 1);
+        REQUIRE(loaded_pairing.draws == 1);
+        REQUIRE(loaded_pairing.pairs == pairing.pairs);
+        REQUIRE(loaded_pairing.decided);
+        REQUIRE(loaded_pairing.unpaired == pairing.unpaired);
+        REQUIRE(loaded.results.completed == results.completed);
+        REQUIRE(loaded.pgn_size == 4321);
+
+        std::filesystem::remove(path);
+    }
+
+    TEST_CASE("Restore PGN") {
+        const auto path = make_path("pgn");
+
+        Settings settings;
+        settings.pgn.enabled = true;
+        settings.pgn.path = path.string();
+
+        {
+            std::ofstream file(path);
+            file << "covered by the checkpoint\nplayed again\n";
+        }
+
+        // Games finished after the checkpoint are cut, as they'll be played again
+        Checkpoint checkpoint;
+        checkpoint.pgn_size = 26;
+        restore_pgn(settings, checkpoint);
+        REQUIRE(std::filesystem::file_size(path) == 26);
+
+        // Checkpoints that don't know about the PGN leave it alone
+        checkpoint.pgn_size.reset();
+        {
+            std::ofstream file(path, std::ofstream::app);
+            file << "more\n";
+        }
+        restore_pgn(settings, checkpoint);
+        REQUIRE(std::filesystem::file_size(path) == 31);
+
+        std::filesystem::remove(path);
+    }
+
+    TEST_CASE("Not a checkpoint") {
+        const auto path = make_path("not-checkpoint");
+
+        REQUIRE_THROWS(load_checkpoint(path.string()));
+
+        {
+            std::ofstream file(path);
+            file << "x5o/7/7/7/7/7/o5x x 0 1\n";
+        }
+        REQUIRE_THROWS(load_checkpoint(path.string()));
+
+        std::filesystem::remove(path);
+    }
+}
@@ -0,0 +1,42 @@
+#include "core/match/results.hpp"
+#include <doctest/doctest.h>
+
+TEST_SUITE("Results - Pairs") {
+    TEST_CASE("Pair games on the same opening") {
+        PairingScore pairing;
+
+        // Opening 0: a win as black, then a draw as white
+        add_to_pairs(pairing, 0, true, 2);
+        REQUIRE(pairing.pairs == std::array<int, 5>{0, 0, 0, 0, 0});
+        add_to_pairs(pairing, 0, false, 1);
+        REQUIRE(pairing.pairs == std::array<int, 5>{0, 0, 0, 1, 0});
+        REQUIRE(pairing.unpaired.empty());
+    }
+
+    TEST_CASE("Out of order") {
+        PairingScore pairing;
+
+        // Games on other openings and the same colours finish in between
+        add_to_pairs(pairing, 3, false, 0);
+        add_to_pairs(pairing, 5, true, 2);
+        add_to_pairs(pairing, 3, false, 2);
+        REQUIRE(pairing.pairs == std::array<int, 5>{0, 0, 0, 0, 0});
+
+        add_to_pairs(pairing, 3, true, 0);
+        add_to_pairs(pairing, 5, false, 2);
+        add_to_pairs(pairing, 3, true, 1);
+        REQUIRE(pairing.pairs == std::array<int, 5>{1, 0, 0, 1, 1});
+        REQUIRE(pairing.unpaired.empty());
+    }
+
+    TEST_CASE("Pentanomial LLR") {
+        PairingScore pairing;
+        pairing.wins = 1382;
+        pairing.losses = 1415;
+        pairing.draws = 2627;
+        pairing.pairs = {100, 900, 2200, 1000, 120};
+
+        REQUIRE(get_sprt_llr(pairing, true, 0.0f, 5.0f) == sprt::get_llr_pentanomial(pairing.pairs, 0.0f, 5.0f));
+        REQUIRE(get_sprt_llr(pairing, false, 0.0f, 5.0f) == sprt::get_llr(1382, 1415, 2627, 0.0f, 5.0f));
+    }
+}
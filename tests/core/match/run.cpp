@@ -0,0 +1,54 @@
+#include "core/match/run.hpp"
+#include <doctest/doctest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+[[nodiscard]] auto make_settings() -> Settings {
+    Settings settings;
+    settings.concurrency = 4;
+    settings.num_games = 4000;
+    settings.ratinginterval = 0;
+    settings.seed = 1;
+    settings.pgn.enabled = false;
+    settings.engines = {
+        EngineSettings{0, EngineProtocol::Unknown, "mc", "mostcaptures", "", "", SearchSettings::as_depth(1), {}},
+        EngineSettings{1, EngineProtocol::Unknown, "random", "random", "", "", SearchSettings::as_depth(1), {}},
+    };
+    return settings;
+}
+
+[[nodiscard]] auto make_callbacks() -> Callbacks {
+    Callbacks callbacks;
+    callbacks.on_engine_start = [](const std::string &) {};
+    callbacks.on_engine_ready = [](const std::string &, const std::chrono::milliseconds) {};
+    callbacks.on_game_started = [](const int, const std::string &, const std::string &) {};
+    callbacks.on_game_finished = [](const int, const std::string &, const std::string &) {};
+    callbacks.on_results_update = [](const Results &) {};
+    return callbacks;
+}
+
+const auto openings = std::vector<std::string>{
+    "x5o/7/7/7/7/7/o5x x 0 1",
+    "x5o/7/2-1-2/7/2-1-2/7/o5x x 0 1",
+    "x5o/7/3-3/2-1-2/3-3/7/o5x x 0 1",
+};
+
+}  // namespace
+
+TEST_SUITE("Run") {
+    TEST_CASE("SPRT stops a two engine match on every thread") {
+        for (const auto reactor : {false, true}) {
+            auto settings = make_settings();
+            settings.reactor = reactor;
+            settings.sprt.enabled = true;
+            settings.sprt.autostop = true;
+
+            const auto results = run(settings, openings, make_callbacks());
+
+            REQUIRE(results.pairings.at({0, 1}).decided);
+            REQUIRE(results.games_played < settings.num_games / 4);
+        }
+    }
+}
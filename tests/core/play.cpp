@@ -1,8 +1,60 @@
 #include "core/play.hpp"
 #include <doctest/doctest.h>
+#include <chrono>
+#include <thread>
 #include "core/engine/builtin/most_captures.hpp"
 #include "core/engine/create.hpp"
 #include "core/engine/settings.hpp"
+#include "core/game.hpp"
+#include "core/play_builtin.hpp"
+
+// Plays like mostcaptures until it dies on its nth move
+class CrashingEngine : public MostCapturesBuiltin {
+   public:
+    [[nodiscard]] CrashingEngine(const int crash_on) : m_crash_on(crash_on) {
+    }
+
+    [[nodiscard]] virtual auto go(const SearchSettings &tc, const EngineClock::time_point deadline)
+        -> std::string override {
+        if (++m_moves == m_crash_on) {
+            m_running = false;
+            throw std::runtime_error("Engine crashed");
+        }
+        return MostCapturesBuiltin::go(tc, deadline);
+    }
+
+    [[nodiscard]] virtual auto is_running() -> bool override {
+        return m_running;
+    }
+
+   private:
+    int m_crash_on = 0;
+    int m_moves = 0;
+    bool m_running = true;
+};
+
+// Plays like mostcaptures, but never answers isready
+class HangingEngine : public MostCapturesBuiltin {
+   public:
+    virtual auto isready() -> void override {
+        throw EngineTimeout(*this, "Engine failed to respond in time");
+    }
+};
+
+// Plays like mostcaptures, but takes its time over the first move
+class SlowEngine : public MostCapturesBuiltin {
+   public:
+    [[nodiscard]] virtual auto go(const SearchSettings &tc, const EngineClock::time_point deadline)
+        -> std::string override {
+        if (m_moves++ == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        return MostCapturesBuiltin::go(tc, deadline);
+    }
+
+   private:
+    int m_moves = 0;
+};
 
 TEST_CASE("Test 1") {
     const auto settings1 =
@@ -37,10 +89,200 @@ TEST_CASE("Test 1") {
 
     // Check endpos is correct according to the history
     auto pos = result1.startpos;
-    for (const auto move_info : result1.history) {
+    for (const auto &move_info : result1.history) {
         REQUIRE(move_info.movetime >= 0);
         REQUIRE(pos.is_legal_move(move_info.move));
         pos.makemove(move_info.move);
     }
     REQUIRE(pos.get_hash() == result1.endpos.get_hash());
 }
+
+TEST_CASE("Send moves") {
+    auto settings1 =
+        EngineSettings{0, EngineProtocol::Unknown, "Test1", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+    auto settings2 =
+        EngineSettings{1, EngineProtocol::Unknown, "Test2", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+
+    const auto adjudication = AdjudicationSettings{{}, {}, {}, 0};
+    const auto game1 = GameSettings{"startpos", settings1, settings2};
+
+    settings1.send_moves = true;
+    settings2.send_moves = true;
+    const auto game2 = GameSettings{"startpos", settings1, settings2};
+
+    // Engines given the moves should see the same positions as engines given the position
+    const auto result1 = play(adjudication, game1, make_engine(settings1, {}, {}), make_engine(settings2, {}, {}));
+    const auto result2 = play(adjudication, game2, make_engine(settings1, {}, {}), make_engine(settings2, {}, {}));
+
+    REQUIRE(result1.result == result2.result);
+    REQUIRE(result1.endpos.get_hash() == result2.endpos.get_hash());
+    REQUIRE(result1.history.size() == result2.history.size());
+    for (std::size_t i = 0; i < result1.history.size(); ++i) {
+        REQUIRE(result1.history[i].move == result2.history[i].move);
+    }
+}
+
+TEST_CASE("Sync policy") {
+    auto settings1 =
+        EngineSettings{0, EngineProtocol::Unknown, "Test1", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+    auto settings2 =
+        EngineSettings{1, EngineProtocol::Unknown, "Test2", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+    settings1.sync = SyncPolicy::NewGame;
+    settings2.sync = SyncPolicy::Never;
+
+    const auto adjudication = AdjudicationSettings{{}, {}, {}, 0};
+    const auto game = GameSettings{"startpos", settings1, settings2};
+    const auto result = play(adjudication, game, make_engine(settings1, {}, {}), make_engine(settings2, {}, {}));
+
+    REQUIRE(!result.history.empty());
+    REQUIRE(result.sync1.count == 1);
+    REQUIRE(result.sync2.count == 0);
+    REQUIRE(result.sync1.skipped + result.sync2.skipped == static_cast<int>(result.history.size()));
+}
+
+TEST_CASE("Recover from crash") {
+    const auto settings1 =
+        EngineSettings{0, EngineProtocol::Unknown, "Test1", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+    const auto settings2 =
+        EngineSettings{1, EngineProtocol::Unknown, "Test2", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+
+    const auto adjudication = AdjudicationSettings{{}, {}, {}, 0};
+    const auto game = GameSettings{"startpos", settings1, settings2};
+    const auto expected = play(adjudication, game, make_engine(settings1, {}, {}), make_engine(settings2, {}, {}));
+
+    // Without a way to restart the engine, the crash loses the game
+    const auto lost = play(adjudication, game, std::make_shared<CrashingEngine>(3), make_engine(settings2, {}, {}));
+    REQUIRE(lost.reason == ResultReason::EngineCrash);
+    REQUIRE(lost.result == libataxx::Result::WhiteWin);
+    REQUIRE(lost.history.size() == 4);
+
+    // A restarted engine picks up where the game left off, so the game goes just as if it never crashed
+    auto num_restarts = 0;
+    const auto restart = [&num_restarts](const EngineSettings &engine) {
+        num_restarts++;
+        return make_engine(engine, {}, {});
+    };
+    const auto recovered = play(
+        adjudication,
+        game,
+        std::make_shared<CrashingEngine>(3),
+        make_engine(settings2, {}, {}),
+        [](GameThingy, SearchSettings, SearchSettings) {
+            return true;
+        },
+        restart);
+
+    REQUIRE(num_restarts == 1);
+    REQUIRE(recovered.restarts1 == 1);
+    REQUIRE(recovered.restarts2 == 0);
+    REQUIRE(recovered.reason == expected.reason);
+    REQUIRE(recovered.result == expected.result);
+    REQUIRE(recovered.endpos.get_hash() == expected.endpos.get_hash());
+    REQUIRE(recovered.history.size() == expected.history.size());
+
+    // An engine that keeps crashing eventually loses anyway
+    const auto crashing = play(
+        adjudication,
+        game,
+        std::make_shared<CrashingEngine>(1),
+        make_engine(settings2, {}, {}),
+        [](GameThingy, SearchSettings, SearchSettings) {
+            return true;
+        },
+        [](const EngineSettings &) {
+            return std::make_shared<CrashingEngine>(1);
+        });
+
+    REQUIRE(crashing.reason == ResultReason::EngineCrash);
+    REQUIRE(crashing.restarts1 == Game::max_restarts);
+    REQUIRE(crashing.history.empty());
+}
+
+TEST_CASE("Timeout off turn") {
+    const auto settings1 =
+        EngineSettings{0, EngineProtocol::Unknown, "Test1", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+    const auto settings2 =
+        EngineSettings{1, EngineProtocol::Unknown, "Test2", "mostcaptures", "", "", SearchSettings::as_depth(1), {}};
+
+    const auto adjudication = AdjudicationSettings{{}, {}, {}, 0};
+    const auto game = GameSettings{"startpos", settings1, settings2};
+
+    // White hangs before black has moved, so it's white that loses
+    const auto result = play(adjudication, game, make_engine(settings1, {}, {}), std::make_shared<HangingEngine>());
+    REQUIRE(result.reason == ResultReason::OutOfTime);
+    REQUIRE(result.result == libataxx::Result::BlackWin);
+    REQUIRE(result.history.empty());
+}
+
+TEST_CASE("Timeout buffer with time control") {
+    const auto tc = SearchSettings::as_time(20, 20, 1000, 1000);
+    const auto settings1 = EngineSettings{0, EngineProtocol::Unknown, "Test1", "mostcaptures", "", "", tc, {}};
+    const auto settings2 = EngineSettings{1, EngineProtocol::Unknown, "Test2", "mostcaptures", "", "", tc, {}};
+    const auto game = GameSettings{"startpos", settings1, settings2};
+
+    // Going past the end of the clock loses
+    const auto lost =
+        play(AdjudicationSettings{{}, {}, {}, 0}, game, std::make_shared<SlowEngine>(), make_engine(settings2, {}, {}));
+    REQUIRE(lost.reason == ResultReason::OutOfTime);
+    REQUIRE(lost.result == libataxx::Result::WhiteWin);
+
+    // Unless it's within the buffer
+    const auto saved = play(
+        AdjudicationSettings{{}, {}, {}, 5000}, game, std::make_shared<SlowEngine>(), make_engine(settings2, {}, {}));
+    REQUIRE(saved.reason != ResultReason::OutOfTime);
+    REQUIRE(!saved.history.empty());
+}
+
+TEST_CASE("Builtin fast path") {
+    const auto adjudication = AdjudicationSettings{300, 30, {}, 0};
+
+    for (const auto &[builtin1, builtin2] : {std::pair{"mostcaptures", "leastcaptures"},
+                                              std::pair{"leastcaptures", "mostcaptures"},
+                                              std::pair{"mostcaptures", "mostcaptures"},
+                                              std::pair{"random", "mostcaptures"},
+                                              std::pair{"random", "random"}}) {
+        const auto settings1 =
+            EngineSettings{0, EngineProtocol::Unknown, "Test1", builtin1, "", "", SearchSettings::as_depth(1), {}};
+        const auto settings2 =
+            EngineSettings{1, EngineProtocol::Unknown, "Test2", builtin2, "", "", SearchSettings::as_depth(1), {}};
+
+        for (const auto &fen : {"startpos", "x5o/7/2-1-2/7/2-1-2/7/o5x x 0 1", "x5o/7/7/7/7/7/o5x o 0 1"}) {
+            const auto game = GameSettings{fen, settings1, settings2, 1234};
+
+            // The builtins should play exactly the same game as they would as engines, given the same seed
+            const auto expected =
+                play(adjudication, game, make_engine(settings1, {}, {}), make_engine(settings2, {}, {}));
+            const auto result = play_builtin(adjudication, game);
+
+            REQUIRE(result);
+            REQUIRE(result->result == expected.result);
+            REQUIRE(result->reason == expected.reason);
+            REQUIRE(result->startpos.get_hash() == expected.startpos.get_hash());
+            REQUIRE(result->endpos.get_hash() == expected.endpos.get_hash());
+            REQUIRE(result->history.size() == expected.history.size());
+            for (std::size_t i = 0; i < result->history.size(); ++i) {
+                REQUIRE(result->history[i].move == expected.history[i].move);
+            }
+        }
+    }
+
+    // The seed decides the game
+    const auto random1 =
+        EngineSettings{0, EngineProtocol::Unknown, "Test1", "random", "", "", SearchSettings::as_depth(1), {}};
+    const auto random2 =
+        EngineSettings{1, EngineProtocol::Unknown, "Test2", "random", "", "", SearchSettings::as_depth(1), {}};
+    const auto game1 = play_builtin(adjudication, GameSettings{"startpos", random1, random2, 1});
+    const auto again = play_builtin(adjudication, GameSettings{"startpos", random1, random2, 1});
+    const auto game2 = play_builtin(adjudication, GameSettings{"startpos", random1, random2, 2});
+    REQUIRE(game1->seed == 1);
+    REQUIRE(game1->endpos.get_hash() == again->endpos.get_hash());
+    REQUIRE(game1->endpos.get_hash() != game2->endpos.get_hash());
+
+    // Only games between two builtins are played this way
+    const auto builtin =
+        EngineSettings{0, EngineProtocol::Unknown, "Test1", "random", "", "", SearchSettings::as_depth(1), {}};
+    const auto process =
+        EngineSettings{1, EngineProtocol::UAI, "Test2", "", "engine", "", SearchSettings::as_depth(1), {}};
+    REQUIRE(play_builtin(adjudication, GameSettings{"startpos", builtin, builtin}));
+    REQUIRE(!play_builtin(adjudication, GameSettings{"startpos", builtin, process}));
+}
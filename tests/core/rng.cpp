@@ -0,0 +1,50 @@
+#include "core/rng.hpp"
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+TEST_SUITE("Rng") {
+    TEST_CASE("Seeds") {
+        auto a = Rng(1);
+        auto b = Rng(1);
+        auto c = Rng(2);
+
+        for (int i = 0; i < 100; ++i) {
+            const auto x = a();
+            REQUIRE(x == b());
+            REQUIRE(x != c());
+        }
+
+        REQUIRE(derive_seed(1, 0) == derive_seed(1, 0));
+        REQUIRE(derive_seed(1, 0) != derive_seed(1, 1));
+        REQUIRE(derive_seed(1, 0) != derive_seed(2, 0));
+    }
+
+    TEST_CASE("Below") {
+        auto rng = Rng(5);
+        std::vector<int> seen(7, 0);
+
+        for (int i = 0; i < 1'000; ++i) {
+            const auto n = rng.below(seen.size());
+            REQUIRE(n < seen.size());
+            seen[n]++;
+        }
+
+        REQUIRE(std::count(seen.begin(), seen.end(), 0) == 0);
+    }
+
+    TEST_CASE("Shuffle") {
+        std::vector<int> a(50);
+        std::iota(a.begin(), a.end(), 0);
+        auto b = a;
+
+        auto rng_a = Rng(42);
+        auto rng_b = Rng(42);
+        std::shuffle(a.begin(), a.end(), rng_a);
+        std::shuffle(b.begin(), b.end(), rng_b);
+
+        REQUIRE(a == b);
+        REQUIRE(!std::is_sorted(a.begin(), a.end()));
+    }
+}
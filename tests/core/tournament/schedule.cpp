@@ -0,0 +1,136 @@
+#include "core/tournament/schedule.hpp"
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "core/tournament/gauntlet.hpp"
+#include "core/tournament/roundrobin.hpp"
+
+TEST_SUITE("Tournament - Schedule") {
+    TEST_CASE("Same games as the generator") {
+        auto gen = RoundRobinGenerator(3, 4, 2, true);
+        auto copy = RoundRobinGenerator(3, 4, 2, true);
+        auto schedule = Schedule(gen);
+
+        REQUIRE(schedule.size() == copy.expected());
+        REQUIRE(schedule.claimed() == 0);
+
+        for (std::size_t i = 0; i < schedule.size(); ++i) {
+            const auto expected = copy.next();
+            REQUIRE(schedule[i] == expected);
+            REQUIRE(schedule.claim() == expected);
+        }
+
+        REQUIRE(!schedule.claim());
+        REQUIRE(!schedule.claim());
+        REQUIRE(schedule.claimed() == schedule.size());
+    }
+
+    TEST_CASE("Start part way through") {
+        auto schedule = Schedule({GameInfo{0, 0, 0, 1}, GameInfo{1, 0, 1, 0}, GameInfo{2, 1, 0, 1}}, 2);
+
+        REQUIRE(schedule.claimed() == 2);
+        REQUIRE(schedule.claim() == GameInfo{2, 1, 0, 1});
+        REQUIRE(!schedule.claim());
+    }
+
+    TEST_CASE("Pairing blocks") {
+        // Two pairings taking turns, 6 games each
+        std::vector<GameInfo> games;
+        for (std::size_t i = 0; i < 12; ++i) {
+            const auto opponent = 1 + i % 2;
+            games.push_back(i % 4 < 2 ? GameInfo{i, i / 4, 0, opponent} : GameInfo{i, i / 4, opponent, 0});
+        }
+
+        auto schedule = Schedule(games);
+        schedule.group_pairings(4);
+
+        const auto pairing = [](const GameInfo &game) {
+            return std::minmax(game.idx_player1, game.idx_player2);
+        };
+
+        // Each pairing gets a block of 4 and a block of 2, with its games still in order
+        const auto upcoming = schedule.upcoming(10);
+        REQUIRE(upcoming.size() == 4);
+        REQUIRE(upcoming[0] == games[0]);
+        REQUIRE(upcoming[1] == games[8]);
+        REQUIRE(upcoming[2] == games[1]);
+        REQUIRE(upcoming[3] == games[9]);
+
+        // Two workers taking turns each stay with the pairing of their own block
+        Schedule::Cursor a;
+        Schedule::Cursor b;
+        std::vector<std::size_t> ids;
+
+        for (std::size_t i = 0; i < games.size() / 2; ++i) {
+            const auto game_a = schedule.claim(a);
+            const auto game_b = schedule.claim(b);
+            REQUIRE(game_a);
+            REQUIRE(game_b);
+            REQUIRE(pairing(*game_a) == pairing(schedule[a.end - 1]));
+            REQUIRE(pairing(*game_b) == pairing(schedule[b.end - 1]));
+            ids.push_back(game_a->id);
+            ids.push_back(game_b->id);
+        }
+
+        REQUIRE(!schedule.claim(a));
+        REQUIRE(!schedule.claim(b));
+        REQUIRE(schedule.claimed() == games.size());
+
+        // Every game is still played once
+        std::sort(ids.begin(), ids.end());
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            REQUIRE(ids[i] == i);
+        }
+    }
+
+    TEST_CASE("Every game claimed once") {
+        auto gen = RoundRobinGenerator(4, 1000, 10, true);
+        auto schedule = Schedule(gen);
+
+        std::vector<std::vector<std::size_t>> claimed(4);
+        std::vector<std::thread> threads;
+        for (auto &ids : claimed) {
+            threads.emplace_back([&schedule, &ids]() {
+                while (const auto game = schedule.claim()) {
+                    ids.push_back(game->id);
+                }
+            });
+        }
+
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        std::vector<std::size_t> all;
+        for (const auto &ids : claimed) {
+            all.insert(all.end(), ids.begin(), ids.end());
+        }
+        std::sort(all.begin(), all.end());
+
+        REQUIRE(all.size() == schedule.size());
+        for (std::size_t i = 0; i < all.size(); ++i) {
+            REQUIRE(all[i] == i);
+        }
+    }
+
+    TEST_CASE("Skip decided pairings") {
+        auto gen = GauntletGenerator(4, 4, 2, true);
+        auto schedule = Schedule(gen);
+
+        // The first game against player 1 is already out when the pairing is decided
+        REQUIRE(schedule.claim() == GameInfo{0, 0, 0, 1});
+        schedule.decide(1, 0);
+        REQUIRE(schedule.is_decided(GameInfo{1, 0, 1, 0}));
+        REQUIRE(!schedule.is_decided(GameInfo{4, 0, 0, 2}));
+
+        // Its slots go to the next pairing straight away
+        REQUIRE(schedule.claim() == GameInfo{4, 0, 0, 2});
+        schedule.decide(0, 3);
+        REQUIRE(schedule.claim() == GameInfo{5, 0, 2, 0});
+        REQUIRE(schedule.claim() == GameInfo{6, 1, 0, 2});
+        REQUIRE(schedule.claim() == GameInfo{7, 1, 2, 0});
+        REQUIRE(!schedule.claim());
+        REQUIRE(schedule.claimed() == schedule.size());
+    }
+}
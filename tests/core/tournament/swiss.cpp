@@ -0,0 +1,140 @@
+#include "core/tournament/swiss.hpp"
+#include <doctest/doctest.h>
+#include <thread>
+#include <vector>
+#include "core/tournament/schedule.hpp"
+
+TEST_SUITE("Tournament - Swiss") {
+    TEST_CASE("First round") {
+        const auto num_players = 4;
+        const auto num_rounds = 2;
+        const auto num_games = 2;
+        const auto num_openings = 3;
+        auto gen = SwissGenerator(num_players, num_rounds, num_games, num_openings);
+
+        REQUIRE(gen.expected() == 8);
+
+        // id, opening, player1, player2
+        REQUIRE(gen.ready());
+        REQUIRE(gen.next() == GameInfo{0, 0, 0, 1});
+        REQUIRE(gen.next() == GameInfo{1, 0, 1, 0});
+        REQUIRE(gen.next() == GameInfo{2, 1, 2, 3});
+        REQUIRE(gen.next() == GameInfo{3, 1, 3, 2});
+
+        // Everyone's playing, so the next round has to wait for results
+        REQUIRE(!gen.ready());
+        REQUIRE(!gen.is_finished());
+    }
+
+    TEST_CASE("Pair by score without waiting for the round") {
+        auto gen = SwissGenerator(6, 2, 1, 1);
+
+        const auto a = gen.next();
+        const auto b = gen.next();
+        const auto c = gen.next();
+        REQUIRE(a == GameInfo{0, 0, 0, 1});
+        REQUIRE(b == GameInfo{1, 0, 2, 3});
+        REQUIRE(c == GameInfo{2, 0, 4, 5});
+        REQUIRE(!gen.ready());
+
+        // The only free engines have just played each other, and have others to play yet
+        gen.record(a, 1.0);
+        REQUIRE(!gen.ready());
+
+        // The winners get paired while the last game of the round is still going, then the losers
+        gen.record(b, 0.0);
+        REQUIRE(gen.ready());
+        REQUIRE(gen.next() == GameInfo{3, 0, 0, 3});
+        REQUIRE(gen.next() == GameInfo{4, 0, 1, 2});
+        REQUIRE(!gen.ready());
+        REQUIRE(!gen.is_finished());
+
+        // Nobody else is left for the last two to play
+        gen.record(c, 0.5);
+        REQUIRE(gen.next() == GameInfo{5, 0, 4, 5});
+        REQUIRE(!gen.ready());
+        REQUIRE(gen.is_finished());
+    }
+
+    TEST_CASE("Avoid rematches") {
+        auto gen = SwissGenerator(4, 3, 1, 1);
+
+        // 0 and 1 both win, 2 and 3 both lose
+        const auto a = gen.next();
+        const auto b = gen.next();
+        gen.record(a, 1.0);
+        gen.record(b, 1.0);
+
+        const auto c = gen.next();
+        const auto d = gen.next();
+        REQUIRE(c == GameInfo{2, 0, 0, 2});
+        REQUIRE(d == GameInfo{3, 0, 1, 3});
+
+        // 0 has played 1 and 2 already, which leaves 3 even though 1 is level with it
+        gen.record(c, 1.0);
+        gen.record(d, 1.0);
+        REQUIRE(gen.next() == GameInfo{4, 0, 0, 3});
+    }
+
+    TEST_CASE("Finish") {
+        auto gen = SwissGenerator(3, 2, 2, 1);
+
+        auto played = 0;
+        while (!gen.is_finished()) {
+            REQUIRE(gen.ready());
+            const auto game = gen.next();
+            gen.record(game, 0.5);
+            played++;
+        }
+
+        // The odd one out sits a round out at the end
+        REQUIRE(played == 6);
+        REQUIRE(!gen.ready());
+        REQUIRE(gen.rounds(0) + gen.rounds(1) + gen.rounds(2) == 6);
+        REQUIRE(gen.points(0) + gen.points(1) + gen.points(2) == 6.0);
+    }
+
+    TEST_CASE("Schedule threads") {
+        const auto num_players = 16;
+        const auto num_rounds = 5;
+        const auto num_games = 2;
+        auto schedule = Schedule(std::make_unique<SwissGenerator>(num_players, num_rounds, num_games, 4));
+
+        std::vector<std::vector<GameInfo>> claimed(4);
+        std::vector<std::thread> threads;
+        for (auto &games : claimed) {
+            threads.emplace_back([&schedule, &games]() {
+                while (true) {
+                    const auto game = schedule.claim();
+                    if (!game) {
+                        if (schedule.wait()) {
+                            continue;
+                        }
+                        return;
+                    }
+                    games.push_back(*game);
+                    schedule.report(*game, game->idx_player1 < game->idx_player2 ? 1.0 : 0.0);
+                }
+            });
+        }
+
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        std::vector<int> played(num_players, 0);
+        std::size_t total = 0;
+        for (const auto &games : claimed) {
+            for (const auto &game : games) {
+                played[game.idx_player1]++;
+                played[game.idx_player2]++;
+                total++;
+            }
+        }
+
+        REQUIRE(total == num_players / 2 * num_rounds * num_games);
+        for (const auto n : played) {
+            REQUIRE(n == num_rounds * num_games);
+        }
+    }
+}